@@ -47,6 +47,124 @@
 #include <sstream>
 #include <algorithm>
 #include <iostream>
+#include <unordered_set>
+#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <string_view>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <limits>
+
+// Block scanning of strings uses SSE2 or NEON when available. Define JSONATOR_NO_SIMD to use the portable code only.
+#if !defined(JSONATOR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSONATOR_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif !defined(JSONATOR_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+#define JSONATOR_NEON
+#include <arm_neon.h>
+#endif
+
+namespace JSONator
+{
+	/*
+	* Describes one member of a struct that is bound with JSONATOR_BIND().
+	* Holds the member's JSON key and a pointer to the member.
+	*/
+	template<typename Owner, typename Member>
+	struct JSON_Field
+	{
+		const char* m_name;
+		size_t m_name_length;
+		Member Owner::* m_member;
+	};
+
+	template<typename Owner, typename Member>
+	constexpr JSON_Field<Owner, Member> make_field(const char* t_name, Member Owner::* t_member) noexcept
+	{
+		return JSON_Field<Owner, Member>{ t_name, std::char_traits<char>::length(t_name), t_member };
+	}
+
+	/*
+	* Lists the fields of a struct that can be used with JSON::parse_into() and JSON::serialize().
+	* Specializations are generated by JSONATOR_BIND() and provide a static fields() method returning a tuple of JSON_Field.
+	*/
+	template<typename T>
+	struct JSON_Binding;
+
+	template<typename T, typename = void>
+	struct is_json_bound : std::false_type {};
+	template<typename T>
+	struct is_json_bound<T, std::void_t<decltype(JSON_Binding<T>::fields())>> : std::true_type {};
+
+	template<typename T>
+	struct is_json_vector : std::false_type {};
+	template<typename T, typename Allocator>
+	struct is_json_vector<std::vector<T, Allocator>> : std::true_type {};
+
+	template<typename T>
+	struct is_json_optional : std::false_type {};
+	template<typename T>
+	struct is_json_optional<std::optional<T>> : std::true_type {};
+}
+
+/*
+* Binds the listed public members of a struct to JSON keys of the same name. Must be used at global namespace scope.
+* Supported member types are bool, integers, floating point, std::string, std::vector, std::optional, and other bound structs.
+* Example: JSONATOR_BIND(User, id, name, tags)
+*/
+#define JSONATOR_BIND(Type, ...) \
+	template<> \
+	struct JSONator::JSON_Binding<Type> \
+	{ \
+		static constexpr auto fields() noexcept { return std::make_tuple(JSONATOR_FIELDS(Type, __VA_ARGS__)); } \
+	};
+
+#define JSONATOR_EXPAND(x) x
+#define JSONATOR_FIELD(Type, member) JSONator::make_field(#member, &Type::member)
+#define JSONATOR_FIELDS_1(Type, a) JSONATOR_FIELD(Type, a)
+#define JSONATOR_FIELDS_2(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_1(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_3(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_2(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_4(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_3(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_5(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_4(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_6(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_5(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_7(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_6(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_8(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_7(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_9(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_8(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_10(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_9(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_11(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_10(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_12(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_11(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_13(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_12(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_14(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_13(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_15(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_14(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_16(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_15(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_17(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_16(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_18(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_17(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_19(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_18(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_20(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_19(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_21(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_20(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_22(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_21(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_23(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_22(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_24(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_23(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_25(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_24(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_26(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_25(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_27(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_26(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_28(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_27(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_29(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_28(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_30(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_29(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_31(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_30(Type, __VA_ARGS__))
+#define JSONATOR_FIELDS_32(Type, a, ...) JSONATOR_FIELD(Type, a), JSONATOR_EXPAND(JSONATOR_FIELDS_31(Type, __VA_ARGS__))
+#define JSONATOR_SELECT_FIELDS(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define JSONATOR_FIELDS(Type, ...) JSONATOR_EXPAND(JSONATOR_SELECT_FIELDS(__VA_ARGS__, JSONATOR_FIELDS_32, JSONATOR_FIELDS_31, JSONATOR_FIELDS_30, JSONATOR_FIELDS_29, JSONATOR_FIELDS_28, JSONATOR_FIELDS_27, JSONATOR_FIELDS_26, JSONATOR_FIELDS_25, JSONATOR_FIELDS_24, JSONATOR_FIELDS_23, JSONATOR_FIELDS_22, JSONATOR_FIELDS_21, JSONATOR_FIELDS_20, JSONATOR_FIELDS_19, JSONATOR_FIELDS_18, JSONATOR_FIELDS_17, JSONATOR_FIELDS_16, JSONATOR_FIELDS_15, JSONATOR_FIELDS_14, JSONATOR_FIELDS_13, JSONATOR_FIELDS_12, JSONATOR_FIELDS_11, JSONATOR_FIELDS_10, JSONATOR_FIELDS_9, JSONATOR_FIELDS_8, JSONATOR_FIELDS_7, JSONATOR_FIELDS_6, JSONATOR_FIELDS_5, JSONATOR_FIELDS_4, JSONATOR_FIELDS_3, JSONATOR_FIELDS_2, JSONATOR_FIELDS_1)(Type, __VA_ARGS__))
 
 namespace JSONator
 {
@@ -54,7 +172,13 @@ namespace JSONator
 	class JSON
 	{
 	private:
-		class Node
+		class Key_Index; // forward declaration
+		class Storage_Pool; // forward declaration
+	public:
+		class Key; // forward declaration
+	private:
+
+		class Node : public std::enable_shared_from_this<Node>
 		{
 			friend class JSON;
 		private:
@@ -66,10 +190,24 @@ namespace JSONator
 			*/
 			class JSON_Value
 			{ 
-				using var_t = std::variant<int, bool, double, std::string, std::shared_ptr<Node>, std::shared_ptr<std::vector<JSON_Value>>>;
+			public:
+				// Parsed number kept as its original text. It is converted when it is read and written back unchanged.
+				struct Number
+				{
+					std::string m_text;
+
+					bool operator==(const Number& t_other) const noexcept { return m_text == t_other.m_text; }
+					bool operator!=(const Number& t_other) const noexcept { return m_text != t_other.m_text; }
+				};
+
+			private:
+				// Arrays are held by value at every level so their elements are contiguous and need no separate allocation.
+				using var_t = std::variant<int, bool, double, std::string, std::shared_ptr<Node>, std::vector<JSON_Value>, std::nullptr_t, Number>;
 			public:
 				var_t m_value_individual = 0;
 				bool m_error_state = 0;
+				bool m_removed = false;		// marked by a removal while removals are deferred
+				Node* m_owner = nullptr;	// object that holds this value or the array it is in
 
 			public:
 				/*
@@ -82,16 +220,15 @@ namespace JSONator
 				*/
 				JSON_Value& an(const int t_index)
 				{
-					std::shared_ptr<std::vector<JSON_Value>>* temp_value_array = std::get_if<std::shared_ptr<std::vector<JSON_Value>>>(&m_value_individual);
-					if (temp_value_array == nullptr || t_index > (*temp_value_array)->size())
+					std::vector<JSON_Value>* temp_value_array = std::get_if<std::vector<JSON_Value>>(&m_value_individual);
+					if (temp_value_array == nullptr || t_index < 0 || static_cast<size_t>(t_index) >= temp_value_array->size() || (*temp_value_array)[t_index].m_removed)
 					{
 						JSON_Value* error_value = heap_allocate_error_value();
 						return *error_value;
 					}
 					else
 					{
-						std::vector<JSON_Value> temp_array = *(*temp_value_array);
-						JSON_Value& temp_value = temp_array[t_index];
+						JSON_Value& temp_value = (*temp_value_array)[t_index];
 						return temp_value;
 					}
 				}
@@ -104,7 +241,12 @@ namespace JSONator
 				* primarily to provide a specific object to the return, update, or delete methods.
 				* @returns JSON_KVP&
 				*/
-				JSON_KVP& dn(const std::string t_key)
+				JSON_KVP& dn(const std::string& t_key)
+				{
+					return dn(Key(t_key));
+				}
+
+				JSON_KVP& dn(const Key& t_key)
 				{
 					// get pointer to m_value_individual
 					std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&m_value_individual);
@@ -114,7 +256,7 @@ namespace JSONator
 						return *error_kvp;
 					}
 
-					JSON_KVP& temp_kvp = (*temp_node)->find_by_key(t_key);
+					JSON_KVP& temp_kvp = (*temp_node)->find_by_key(t_key.m_text);
 
 					return temp_kvp;
 				}
@@ -122,15 +264,18 @@ namespace JSONator
 			};
 			/*
 			* Class that represents the Key-Value pair structure.
-			* m_value can be either an individual object or a vector of objects. In the former case m_value holds either
-			* a primitive type or a pointer to a heap allocated Node object. In the latter case m_value represents an array.
+			* m_value holds either a primitive type, a pointer to a heap allocated Node object, or an array, in the same
+			* form as a value anywhere else in the document.
 			*/
 			class JSON_KVP
 			{
 			public:
 				std::string m_key;
-				std::variant<JSON_Value, std::vector<JSON_Value>> m_value;
+				JSON_Value m_value;
 				bool m_error_state = false;
+				bool m_removed = false;		// marked by a removal while removals are deferred
+				Node* m_owner = nullptr;	// object that holds this pair
+				size_t m_index_order = 0;	// position of this pair in document order, numbered by the key index
 
 			public:
 				const static JSON_KVP make_kvp(const std::string& t_key, const JSON_Value& t_value) noexcept
@@ -145,7 +290,7 @@ namespace JSONator
 				{
 					JSON_KVP temp_kvp;
 					temp_kvp.m_key = t_key;
-					temp_kvp.m_value = t_value;
+					temp_kvp.m_value.m_value_individual = t_value;
 					return temp_kvp;
 				}
 
@@ -167,17 +312,7 @@ namespace JSONator
 				*/
 				JSON_Value& an(const int t_index)
 				{
-					std::vector<JSON_Value>* temp_value_array = std::get_if<std::vector<JSON_Value>>(&m_value);
-					if (temp_value_array == nullptr || t_index > temp_value_array->size())
-					{
-						JSON_Value* error_value = heap_allocate_error_value();
-						return *error_value;
-					}
-					else
-					{
-						Node::JSON_Value& temp_value = (*temp_value_array)[t_index];
-						return temp_value;
-					}
+					return m_value.an(t_index);
 				}
 
 				/*
@@ -190,32 +325,85 @@ namespace JSONator
 				*/
 				JSON_KVP& dn(const std::string& t_key)
 				{
-					// get pointer to m_value
-					JSON_Value* temp_value = std::get_if<JSON_Value>(&m_value);
-					if (temp_value == nullptr)
+					return m_value.dn(Key(t_key));
+				}
+
+				JSON_KVP& dn(const Key& t_key)
+				{
+					return m_value.dn(t_key);
+				}
+			};
+
+		private:
+			/*
+			* Content hash of an object, see JSON::hash(). The hash is computed lazily by const methods, so it is kept
+			* in atomics to let several threads hash the same const JSON at once. Threads that race to fill it store
+			* the same value. Copies take the cached value.
+			*/
+			class Hash_Cache
+			{
+			public:
+				Hash_Cache() = default;
+
+				Hash_Cache(const Hash_Cache& t_other) noexcept
+				{
+					*this = t_other;
+				}
+
+				Hash_Cache& operator=(const Hash_Cache& t_other) noexcept
+				{
+					size_t temp_hash = 0;
+					if (t_other.get(temp_hash))
 					{
-						JSON_KVP* error_kvp = heap_allocate_error_kvp();
-						return *error_kvp;
+						set(temp_hash);
 					}
-					// get pointer to m_value_individual - stored in m_value
-					std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&temp_value->m_value_individual);
-					if (temp_node == nullptr)
+					else
 					{
-						JSON_KVP* error_kvp = heap_allocate_error_kvp();
-						return *error_kvp;
+						reset();
 					}
+					return *this;
+				}
 
-					JSON_KVP& temp_kvp = (*temp_node)->find_by_key(t_key);
-					return temp_kvp;
+				bool get(size_t& t_hash) const noexcept
+				{
+					if (!m_valid.load(std::memory_order_acquire))
+					{
+						return false;
+					}
+					t_hash = m_hash.load(std::memory_order_relaxed);
+					return true;
+				}
+
+				void set(size_t t_hash) const noexcept
+				{
+					m_hash.store(t_hash, std::memory_order_relaxed);
+					m_valid.store(true, std::memory_order_release);
 				}
+
+				void reset() noexcept
+				{
+					m_valid.store(false, std::memory_order_relaxed);
+				}
+
+			private:
+				mutable std::atomic<bool> m_valid{ false };
+				mutable std::atomic<size_t> m_hash{ 0 };
 			};
 
 		private:
 			std::string m_object_key;
 			std::variant<std::monostate, JSON_KVP, std::vector<JSON_KVP>> m_kvp;
+			Node* m_parent = nullptr;			// enclosing object, or nullptr for the document root
+			Key_Index* m_key_index = nullptr;	// set on the document root while a key index is enabled
+			bool m_defer_removals = false;		// set on the document root between begin_removals() and end_removals()
+			bool m_cache_serialized = false;	// set on the document root while the serialize cache is enabled
+			mutable bool m_serialized_valid = false;
+			mutable std::string m_serialized;	// text of this object from the last serialize() that used the cache
+			Hash_Cache m_hash;
 
 		private:
-			JSON_KVP& find_by_key(const std::string& t_key)
+			// Keys are compared with leading and trailing spaces removed, without copying them.
+			JSON_KVP& find_by_key(const std::string_view t_key)
 			{
 				std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&m_kvp);
 				if (temp_kvp_array == nullptr)
@@ -228,7 +416,7 @@ namespace JSONator
 					for (int i = 0; i < temp_kvp_array->size(); i++)
 					{
 						Node::JSON_KVP& temp_kvp = (*temp_kvp_array)[i];
-						if (format_value(temp_kvp.m_key) == t_key)
+						if (!temp_kvp.m_removed && trim_spaces(temp_kvp.m_key) == t_key)
 						{
 							return temp_kvp;
 						}
@@ -238,44 +426,66 @@ namespace JSONator
 				}
 			}
 
-			std::pair<std::vector<Node::JSON_KVP>*, int> recursive_find_parent_vector_and_index(const std::string& t_key, const int t_function_level = 0)
+			/*
+			* Depth first search in document order for the first pair with the given key, descending into nested
+			* objects and into objects inside arrays.
+			* @returns The vector holding the pair and its index, or nullptr and -1 if the key was not found.
+			*/
+			std::pair<std::vector<Node::JSON_KVP>*, int> recursive_find_parent_vector_and_index(const std::string& t_key)
 			{
 				std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&m_kvp);
-				std::pair<std::vector<Node::JSON_KVP>*, int> return_value;
 				if (temp_kvp_array == nullptr)
 				{
 					return std::make_pair(nullptr, -1);
 				}
-				else
+				for (size_t i = 0; i < temp_kvp_array->size(); i++)
 				{
-					for (int i = 0; i < temp_kvp_array->size(); i++)
+					Node::JSON_KVP& temp_kvp = (*temp_kvp_array)[i];
+					if (temp_kvp.m_removed)
 					{
-						Node::JSON_KVP& temp_kvp = (*temp_kvp_array)[i];
-						Node::JSON_Value* temp_value = std::get_if<JSON_Value>(&temp_kvp.m_value);
-						if (temp_value != nullptr && std::holds_alternative<std::shared_ptr<Node>>(temp_value->m_value_individual))
-						{
-							std::pair<std::vector<Node::JSON_KVP>*, int> temp_pair = std::make_pair(nullptr, 0);
-							std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&temp_value->m_value_individual);
-							if (std::holds_alternative<std::vector<Node::JSON_KVP>>((*temp_node)->m_kvp))
-							{
-								temp_pair = (*temp_node)->recursive_find_parent_vector_and_index(t_key, t_function_level + 1);
-								if (t_function_level > 0)
-								{
-									return temp_pair;
-								}
-								else if (t_function_level == 0 && temp_pair.first != nullptr)
-								{
-									return temp_pair;
-								}
-							}
-						}
-						else if (format_value(temp_kvp.m_key) == t_key)
-						{
-							return std::make_pair(temp_kvp_array, i);
-						}
-						return std::make_pair(nullptr, -1); // Failed to find key
+						continue;
+					}
+					if (temp_kvp.m_key == t_key)
+					{
+						return std::make_pair(temp_kvp_array, static_cast<int>(i));
+					}
+					std::pair<std::vector<Node::JSON_KVP>*, int> temp_pair = find_in_value(temp_kvp.m_value, t_key);
+					if (temp_pair.first != nullptr)
+					{
+						return temp_pair;
+					}
+				}
+				return std::make_pair(nullptr, -1); // Failed to find key
+			}
+
+			static std::pair<std::vector<Node::JSON_KVP>*, int> find_in_value(JSON_Value& t_value, const std::string& t_key)
+			{
+				if (t_value.m_removed)
+				{
+					return std::make_pair(nullptr, -1);
+				}
+				if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+				{
+					return (*temp_node)->recursive_find_parent_vector_and_index(t_key);
+				}
+				if (std::vector<JSON_Value>* temp_array = std::get_if<std::vector<JSON_Value>>(&t_value.m_value_individual))
+				{
+					return find_in_array(*temp_array, t_key);
+				}
+				return std::make_pair(nullptr, -1);
+			}
+
+			static std::pair<std::vector<Node::JSON_KVP>*, int> find_in_array(std::vector<JSON_Value>& t_array, const std::string& t_key)
+			{
+				for (JSON_Value& element : t_array)
+				{
+					std::pair<std::vector<Node::JSON_KVP>*, int> temp_pair = find_in_value(element, t_key);
+					if (temp_pair.first != nullptr)
+					{
+						return temp_pair;
 					}
 				}
+				return std::make_pair(nullptr, -1);
 			}
 
 		public:
@@ -333,7 +543,7 @@ namespace JSONator
 			{
 				JSON_KVP* temp_ptr = std::get_if<JSON_KVP>(&m_kvp);
 				std::vector<JSON_Value> init_vector;
-				temp_ptr->m_value = init_vector;
+				temp_ptr->m_value.m_value_individual = init_vector;
 			}
 			// declares that this node contains an object and initializes the node with an empty object
 			void init_object (const std::string& t_key, const std::vector<JSON_KVP>& t_value_object) noexcept
@@ -346,1358 +556,8789 @@ namespace JSONator
 
 	private:
 		Node main_list;
+		std::unique_ptr<Key_Index> m_key_index;
+		std::unique_ptr<Storage_Pool> m_storage;	// storage kept by clear() for reuse, see Parser
 
-	private:
-
-		//*************************************** STATIC HELPER FUNCTIONS ***************************************\\
-
-		static std::string json_remove_space(std::string t_json_input)
-		{
-			std::string formatted_json;
-			std::string::iterator it;
-			it = t_json_input.begin();
-
-			while (it != t_json_input.end())
-			{
-				if (*it == ' ')
-				{
-					it++;
-				}
-				else if (*it == '"')
-				{
-					formatted_json.push_back(*it); // Opening quote
-					it++;
-
-					while (*it != '"')
-					{
-						formatted_json.push_back(*it);
-						it++;
-					}
-
-					formatted_json.push_back(*it); // Closing quote
-					it++;
-				}
-				else if (*it == '\'')
-				{
-					formatted_json.push_back(*it); // Opening quote
-					it++;
-
-					while (*it != '\'')
-					{
-						formatted_json.push_back(*it);
-						it++;
-					}
-
-					formatted_json.push_back(*it); // Closing quote
-					it++;
-				}
-				else
-				{
-					formatted_json.push_back(*it);
-					it++;
-				}
-			}
+	public:
+		JSON() = default;
 
-			return formatted_json;
-		}
-		
-		/*
-		* Heap allocates a JSON_Value object with the m_error_state flag set to true.
-		* Object must be deleted by the return, update, or delete function when checking for error state.
-		* @returns raw pointer
-		*/
-		static Node::JSON_Value* heap_allocate_error_value()
+		// Copies are deep so that every node has exactly one parent.
+		JSON(const JSON& t_other)
 		{
-			Node::JSON_Value* error_object(new Node::JSON_Value); 
-			error_object->m_error_state = true;
-			return error_object;
+			copy_from(t_other);
 		}
 
-		/*
-		* Heap allocates a JSON_KVP object with the m_error_state flag set to true.
-		* Object must be deleted by the return, update, or delete function when checking for error state.
-		* @returns raw pointer
-		*/
-		static Node::JSON_KVP* heap_allocate_error_kvp()
+		JSON(JSON&& t_other) noexcept : main_list(std::move(t_other.main_list)), m_key_index(std::move(t_other.m_key_index)), m_storage(std::move(t_other.m_storage))
 		{
-			Node::JSON_KVP* error_object(new Node::JSON_KVP);
-			error_object->m_error_state = true;
-			return error_object;
+			relink_root();
 		}
 
-		/* 
-		* Checks if a string represents an integer, double, or neither.
-		* @param t_string_input String to be evaluated
-		* @returns Int indicating the type held in the string argument
-		* 0 = NAN, 1 = INTEGER, 2 = DOUBLE
-		*/
-		const static int is_number(std::string t_string_input)
+		JSON& operator=(const JSON& t_other)
 		{
-			// remove whitespace from string
-			t_string_input.erase(std::remove_if(t_string_input.begin(), t_string_input.end(), ::isspace), t_string_input.end());
-
-			int decimal_counter = 0;
-			for (int i = 0; i < t_string_input.size(); i++)
+			if (this != &t_other)
 			{
-				if (std::isdigit(static_cast<unsigned char>(t_string_input[i])))
-				{
-					continue;
-				}
-				else if (t_string_input[i] == '.')
-				{
-					decimal_counter++;
-					continue;
-				}
-				else if (t_string_input[i] == '-')
-				{
-					continue;
-				}
-				else
-				{
-					return 0;
-				}
-			}
-			if (decimal_counter == 0)
-			{
-				return 1;
-			}
-			else if (decimal_counter == 1)
-			{
-				return 2;
-			}
-			else
-			{
-				return 0;
+				copy_from(t_other);
 			}
+			return *this;
 		}
 
-		/**
-		* Determines type from string input.
-		* @param t_string_input Input string to be evaluated.
-		* @returns Int indindicating the type held in the string argument:
-		* 0 = NULL/SYNTAX ERROR, 1 = INTEGER, 2 = DOUBLE, 3 = BOOL, 4 = STRING, 5 = NODE, 6 = ARRAY
-		*/
-		const static int check_type(std::string t_string_input) noexcept
+		JSON& operator=(JSON&& t_other) noexcept
 		{
-			if (t_string_input[0] == '"') // check for string
-			{
-				return 4;
-			}
-			else if (t_string_input[0] == '[') // check for array
+			if (this != &t_other)
 			{
-				return 6;
-			}
-			else if (t_string_input[0] == '{') // check for object
-			{
-				return 5;
-			}
-			else if (t_string_input[0] == 'f' || t_string_input[0] == 't') // check for bool
-			{
-				return 3;
-			}
-			else
-			{
-				return is_number(t_string_input);
+				main_list = std::move(t_other.main_list);
+				m_key_index = std::move(t_other.m_key_index);
+				m_storage = std::move(t_other.m_storage);
+				relink_root();
 			}
+			return *this;
 		}
 
+	private:
 		/*
-		* Formats and converts a string to a double
-		* @param t_double_string String representing a double. May contain whitespace.
-		* @returns A double
+		* Bounds checked cursor over JSON text. Every read method advances past the token it reads and returns false
+		* on a syntax error, recording the offset of the error. Whitespace is skipped by the caller with
+		* skip_whitespace() so the scanner can be shared by parsers that handle whitespace differently.
+		* Accepts the same relaxed input as parse(): unquoted keys and single quoted strings are allowed.
 		*/
-		const static double convert_to_double(std::string t_double_string)
+		class Scanner
 		{
-			// remove whitespace
-			t_double_string.erase(std::remove_if(t_double_string.begin(), t_double_string.end(), ::isspace), t_double_string.end());
-
-			return std::stod(t_double_string);
-		}
+		public:
+			const char* m_begin;
+			const char* m_current;
+			const char* m_end;
+			bool m_error = false;
+			size_t m_error_offset = 0;
 
-		/*
-		* Formats and converts a string to an int
-		* @param t_integer_string String representing an int. May contain whitespace.
-		* @returns An int
-		*/
-		const static int convert_to_int(std::string t_integer_string)
-		{
-			// remove whitespace
-			t_integer_string.erase(std::remove_if(t_integer_string.begin(), t_integer_string.end(), ::isspace), t_integer_string.end());
+		public:
+			Scanner(const char* t_begin, const char* t_end) noexcept : m_begin(t_begin), m_current(t_begin), m_end(t_end) {}
 
-			return std::stoi(t_integer_string);
-		}
+			bool at_end() const noexcept
+			{
+				return m_current >= m_end;
+			}
 
-		/**
-		* Removes leading and trailing white spaces from input.
-		* @param t_string_input String to be formatted
-		* @returns std::string
-		*/
-		const static std::string format_value(std::string t_string_input)
-		{
-			int len_counter = 0;
-			// count leading spaces if any
-			while (t_string_input[len_counter] == ' ')
+			// Returns the current character or '\0' at the end of input.
+			char peek() const noexcept
 			{
-				len_counter++;
+				return m_current < m_end ? *m_current : '\0';
 			}
-			// erase leading spaces if any found
-			if (len_counter > 0)
+
+			size_t offset() const noexcept
 			{
-				t_string_input.erase(0, len_counter);
+				return static_cast<size_t>(m_current - m_begin);
 			}
-			// count trailing spaces if any
-			len_counter = 0;
-			for (int i = t_string_input.size() - 1; i > -1; i--)
+
+			// Records the first error and returns false so callers can write 'return fail();'
+			bool fail() noexcept
 			{
-				if (t_string_input[i] == ' ')
-				{
-					len_counter++;
-				}
-				else
+				if (!m_error)
 				{
-					break;
+					m_error = true;
+					m_error_offset = offset();
 				}
+				return false;
 			}
-			// erase trailing spaces if any found
-			if (len_counter > 0)
+
+			void skip_whitespace() noexcept
 			{
-				std::string::iterator it = t_string_input.end() - len_counter;
-				t_string_input.erase(it, t_string_input.end());
+				while (m_current < m_end && (*m_current == ' ' || *m_current == '\t' || *m_current == '\n' || *m_current == '\r'))
+				{
+					m_current++;
+				}
 			}
-			return t_string_input;
-		}
 
-		/**
-		* Removes quotation marks from the first and last position in a string.
-		* @param t_string_input String to be edited.
-		* @attention Assumes no leading or trailing whitespace. Format with format_value()
-		* first if needed.
-		* @see format_value()
-		*/
-		const static std::string remove_quotes(std::string t_string_input)
-		{
-			if (t_string_input[0] == '"')
+			// Consumes t_char if it is the next character.
+			bool consume(const char t_char) noexcept
 			{
-				t_string_input.erase(0, 1);
+				if (m_current < m_end && *m_current == t_char)
+				{
+					m_current++;
+					return true;
+				}
+				return false;
 			}
 
-			if (t_string_input[t_string_input.size()] == '"')
+			// Consumes t_literal if the input continues with it.
+			bool consume_literal(const char* t_literal) noexcept
 			{
-				t_string_input.erase(t_string_input.size(), 1);
+				const char* it = m_current;
+				while (*t_literal != '\0')
+				{
+					if (it >= m_end || *it != *t_literal)
+					{
+						return false;
+					}
+					it++;
+					t_literal++;
+				}
+				m_current = it;
+				return true;
 			}
-			return t_string_input;
-		}
 
-		/*
-		* Overloaded method that converts an array represented in a JSON_KVP and returns a
-		* "flat packed" JSON array.
-		* @returns std::string
-		*/
-		const static std::string convert_to_text(const std::vector<Node::JSON_Value>& t_input_array)
-		{
-			std::stringstream output;
-			output << "[";
-
-			for (int i = 0; i < t_input_array.size(); i++)
+			/*
+			* Reads a quoted string and decodes its escape sequences into t_output.
+			* \uXXXX escapes, including surrogate pairs, are written as UTF-8.
+			* Plain ASCII is found in blocks and copied in one append, other bytes must be valid UTF-8.
+			* @returns false if the string is unterminated or contains an invalid escape or UTF-8 sequence.
+			*/
+			bool read_string(std::string& t_output)
 			{
-				Node::JSON_Value current_index = t_input_array[i];
-				std::string converted_value = "";
-				//determine type and convert to string
-				if (std::holds_alternative<int>(current_index.m_value_individual))
-				{
-					converted_value = std::to_string(std::get<int>(current_index.m_value_individual));
-				}
-				else if (std::holds_alternative<double>(current_index.m_value_individual))
-				{
-					converted_value = std::to_string(std::get<double>(current_index.m_value_individual));
-				}
-				else if (std::holds_alternative<bool>(current_index.m_value_individual))
-				{
-					converted_value = std::to_string(std::get<bool>(current_index.m_value_individual));
-				}
-				else if (std::holds_alternative<std::string>(current_index.m_value_individual))
-				{
-					converted_value = std::get<std::string>(current_index.m_value_individual);
-				}
-				// determine whether to end the array
-				if (i < (t_input_array.size() - 1))
+				t_output.clear();
+				if (m_current >= m_end || (*m_current != '"' && *m_current != '\''))
 				{
-					output << converted_value << ", ";
+					return fail();
 				}
-				else
+				const char quote = *m_current++;
+				while (m_current < m_end)
 				{
-					output << converted_value << ']';
+					// copy the run of plain ASCII characters in one append
+					const char* run_begin = m_current;
+					m_current = find_string_special(m_current, m_end, quote);
+					t_output.append(run_begin, m_current);
+					if (m_current >= m_end)
+					{
+						break;
+					}
+					if (*m_current == quote)
+					{
+						m_current++;
+						return true;
+					}
+					if (*m_current == '\\')
+					{
+						if (!read_escape(t_output))
+						{
+							return false;
+						}
+						continue;
+					}
+					// multi-byte UTF-8 sequence
+					const char* sequence_begin = m_current;
+					if (!validate_utf8(m_current, m_end))
+					{
+						return fail();
+					}
+					t_output.append(sequence_begin, m_current);
 				}
+				return fail();
 			}
-			return output.str();
-		}
-		static std::string convert_to_text(const std::shared_ptr<std::vector<Node::JSON_Value>>& t_input_array)
-		{
-			std::stringstream output;
-			output << "[ ";
-			std::vector<Node::JSON_Value> temp_value_vector = *t_input_array;
-			for (int i = 0; i < temp_value_vector.size(); i++)
+
+			// Reads a quoted or unquoted object key. Unquoted keys end at ':' or whitespace.
+			bool read_key(std::string& t_output)
 			{
-				Node::JSON_Value current_index = temp_value_vector[i];
-				std::string converted_value = "";
-				//determine type and convert to string
-				if (std::holds_alternative<int>(current_index.m_value_individual))
+				if (peek() == '"' || peek() == '\'')
 				{
-					converted_value = std::to_string(std::get<int>(current_index.m_value_individual));
+					return read_string(t_output);
 				}
-				else if (std::holds_alternative<double>(current_index.m_value_individual))
+				t_output.clear();
+				const char* key_begin = m_current;
+				while (m_current < m_end && *m_current != ':' && *m_current != ' ' && *m_current != '\t' && *m_current != '\n' && *m_current != '\r')
 				{
-					converted_value = std::to_string(std::get<double>(current_index.m_value_individual));
+					if (*m_current == '{' || *m_current == '}' || *m_current == '[' || *m_current == ']' || *m_current == ',')
+					{
+						return fail();
+					}
+					m_current++;
 				}
-				else if (std::holds_alternative<bool>(current_index.m_value_individual))
+				if (m_current == key_begin)
 				{
-					converted_value = std::to_string(std::get<bool>(current_index.m_value_individual));
+					return fail();
 				}
-				else if (std::holds_alternative<std::string>(current_index.m_value_individual))
+				t_output.assign(key_begin, m_current);
+				return true;
+			}
+
+			/*
+			* Reads the characters of a number without converting them.
+			* @param t_number_begin Set to the first character of the number.
+			* @param t_number_end Set one past the last character of the number.
+			*/
+			bool read_number(const char*& t_number_begin, const char*& t_number_end) noexcept
+			{
+				t_number_begin = m_current;
+				if (m_current < m_end && *m_current == '-')
 				{
-					converted_value = std::get<std::string>(current_index.m_value_individual);
+					m_current++;
 				}
-				// determine whether to end the array
-				if (i < (temp_value_vector.size() - 1))
+				const char* digits_begin = m_current;
+				while (m_current < m_end && (std::isdigit(static_cast<unsigned char>(*m_current)) || *m_current == '.' || *m_current == 'e' || *m_current == 'E'
+					|| ((*m_current == '-' || *m_current == '+') && (m_current[-1] == 'e' || m_current[-1] == 'E'))))
 				{
-					output << converted_value << ", ";
+					m_current++;
 				}
-				else
+				t_number_end = m_current;
+				if (m_current == digits_begin)
 				{
-					output << converted_value << ']';
+					return fail();
 				}
+				return true;
 			}
-			return output.str();
-		}
-
-		//************************************************ CREATE ***********************************************\\
 
-		/**
-		* Parses a JSON object from a std::string.
-		* This is the entry point to a recursive loop that will traverse a JSON object of unknown size and structure
-		* while populating a vector of JSON_KVP objects that mirrors the original structure. Calls get_value()
-		* which will then return a primitive, call read_array(), or make a recursive call to read_object().
-		* Note that read_array also calls get_value() if the array contains an object.
-		* @param t_object_input The object value to be parsed.
-		* @returns A vector of JSON_KVP objects which is the basis for the JSON object.
-		* @see get_value()
-		*/
-		static std::vector<Node::JSON_KVP> read_object(std::string t_object_input)
-		{
-			std::string::iterator it = t_object_input.begin();
-			std::vector<Node::JSON_KVP> temp_kvp_array;
-			std::string key;
-			std::string value;
-
-			// skip any leading white space
-			while (*it == ' ') { it++; }
-			// return an empty kvp array if not reading a JSON object
-			// if (*it != '{') { return temp_kvp_array; }
-			// move iterator off of the opening brace
-			//it++;
-			// loop through key value pairs
-			while (true)
+			// Returns true if the characters in [t_begin, t_end) form a number with a fraction or exponent.
+			static bool is_floating_point(const char* t_begin, const char* t_end) noexcept
 			{
-				// if object move iterator off opening brace (should only occur for the first opening brace in the object)
-				if (*it == '{')
+				for (const char* it = t_begin; it < t_end; it++)
 				{
-					it++;
+					if (*it == '.' || *it == 'e' || *it == 'E')
+					{
+						return true;
+					}
 				}
-				// skip white space in-between blocks
-				while (*it == ' ' || *it == ',')
+				return false;
+			}
+
+			/*
+			* Skips over the next value without decoding it. Objects and arrays are skipped by matching brackets,
+			* ignoring any brackets that appear inside strings.
+			*/
+			bool skip_value() noexcept
+			{
+				skip_whitespace();
+				char first = peek();
+				if (first == '"' || first == '\'')
 				{
-					it++;
+					return skip_string();
 				}
-				// check for end of object - this has to happen after the whitespace has been skipped
-				// or the iterator goes off the end of the string.
-				if (*it == '}') 
+				if (first != '{' && first != '[')
 				{
-					break;
+					// primitive - read up to the next delimiter
+					const char* value_begin = m_current;
+					while (m_current < m_end && *m_current != ',' && *m_current != '}' && *m_current != ']'
+						&& *m_current != ' ' && *m_current != '\t' && *m_current != '\n' && *m_current != '\r')
+					{
+						m_current++;
+					}
+					return m_current != value_begin ? true : fail();
 				}
-				// check for array and skip key parsing if found
-				if (*it != '[')
+				int depth = 0;
+				while (m_current < m_end)
 				{
-					// read key
-					if (*it == '"')
+					char current = *m_current;
+					if (current == '"' || current == '\'')
 					{
-						it++;
-						while (*it != '"')
+						if (!skip_string())
 						{
-							key.push_back(*it);
-							it++;
+							return false;
 						}
-						while (*it != ':') // skip to value
+						continue;
+					}
+					if (current == '{' || current == '[')
+					{
+						depth++;
+					}
+					else if (current == '}' || current == ']')
+					{
+						depth--;
+						if (depth == 0)
 						{
-							it++;
+							m_current++;
+							return true;
 						}
-						it++;
 					}
-					else
+					m_current++;
+				}
+				return fail();
+			}
+
+			// Skips a quoted string, honoring backslash escapes.
+			bool skip_string() noexcept
+			{
+				const char quote = *m_current++;
+				while (m_current < m_end)
+				{
+					m_current = find_string_special(m_current, m_end, quote);
+					if (m_current >= m_end)
 					{
-						while (*it != ':')
+						break;
+					}
+					if (*m_current == '\\')
+					{
+						if (m_end - m_current < 2)
 						{
-							key.push_back(*it);
-							it++;
+							break;
 						}
-						it++;
+						m_current += 2;
+						continue;
 					}
-					// format key
-					key = format_value(key);
-					// skip white space in-between blocks
-					while (*it == ' ')
+					if (*m_current++ == quote)
 					{
-						it++;
+						return true;
 					}
 				}
-				// read value
-				if (*it == '"') // string
+				m_current = m_end;
+				return fail();
+			}
+
+			/*
+			* Returns the first quote, backslash, or non-ASCII byte in [t_it, t_end), or t_end if there is none.
+			* Checks 16 bytes at a time with SSE2 or NEON, and 8 bytes at a time in a 64 bit word otherwise.
+			*/
+			static const char* find_string_special(const char* t_it, const char* t_end, const char t_quote) noexcept
+			{
+#if defined(JSONATOR_SSE2)
+				const __m128i quotes = _mm_set1_epi8(t_quote);
+				const __m128i backslashes = _mm_set1_epi8('\\');
+				while (t_end - t_it >= 16)
 				{
-					do
+					const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_it));
+					// the sign bit of each byte of chunk marks non-ASCII bytes
+					const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, backslashes)), chunk)));
+					if (mask != 0)
 					{
-						value.push_back(*it);
-						it++;
-					} while (*it != '"');
-					// grab closing quote
-					value.push_back(*it);
-					it++;
+						return t_it + lowest_bit(mask);
+					}
+					t_it += 16;
 				}
-				else if (*it == '\'') // also string
+#elif defined(JSONATOR_NEON)
+				const uint8x16_t quotes = vdupq_n_u8(static_cast<uint8_t>(t_quote));
+				const uint8x16_t backslashes = vdupq_n_u8('\\');
+				const uint8x16_t non_ascii = vdupq_n_u8(0x80);
+				while (t_end - t_it >= 16)
 				{
-					do
+					const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(t_it));
+					const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quotes), vceqq_u8(chunk, backslashes)), vcgeq_u8(chunk, non_ascii));
+					if (vmaxvq_u8(special) != 0)
 					{
-						value.push_back(*it);
-						it++;
-					} while (*it != '\'');
-					// grab closing quote
-					value.push_back(*it);
-					it++;
+						break;	// the word and byte loops below find the position
+					}
+					t_it += 16;
 				}
-				else if (*it == '[') // array
+#endif
+				const uint64_t ones = 0x0101010101010101ULL;
+				const uint64_t high_bits = 0x8080808080808080ULL;
+				while (t_end - t_it >= 8)
 				{
-					/*while (*it != ']')
-					{
-						value.push_back(*it);
-						it++;
-					}*/
-
-					// Capture opening brace
-					value.push_back(*it);
-					it++;
-
-					int array_counter = 1;
-					while (array_counter != 0)
+					uint64_t word = 0;
+					std::memcpy(&word, t_it, sizeof(word));
+					const uint64_t quotes = word ^ (ones * static_cast<unsigned char>(t_quote));
+					const uint64_t backslashes = word ^ (ones * static_cast<unsigned char>('\\'));
+					// a zero byte in quotes or backslashes marks a match, may also mark bytes after a match
+					if ((((quotes - ones) & ~quotes) | ((backslashes - ones) & ~backslashes) | word) & high_bits)
 					{
-						if (*it == '[') // must track how many nested arrays we are reading 
-						{
-							array_counter++;
-						}
-						else if (*it == ']')
-						{
-							array_counter--;
-						}
-						value.push_back(*it);
-						it++;
+						break;
 					}
-					//value.push_back(*it);
+					t_it += 8;
 				}
-				else if (*it == '{') // object
+				while (t_it < t_end && *t_it != t_quote && *t_it != '\\' && static_cast<unsigned char>(*t_it) < 0x80)
 				{
-					value.push_back(*it);
-					it++; // move iterator off of opening brace so it is not double counted
+					t_it++;
+				}
+				return t_it;
+			}
 
-					int object_counter = 1;
-					while (object_counter != 0)
-					{
-						if (*it == '{') // must track how many nested objects we are reading 
-						{
-							object_counter++;
-						}
-						else if (*it == '}')
-						{
-							object_counter--;
-						}
-						value.push_back(*it);
-						it++;
-					}
-					value.push_back(*it); // push closing brace - read object will overflow without it
+		private:
+#if defined(JSONATOR_SSE2)
+			static int lowest_bit(const unsigned int t_mask) noexcept
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				unsigned long index = 0;
+				_BitScanForward(&index, t_mask);
+				return static_cast<int>(index);
+#else
+				return __builtin_ctz(t_mask);
+#endif
+			}
+#endif
+
+			static int hex_digit(const char t_char) noexcept
+			{
+				if (t_char >= '0' && t_char <= '9') { return t_char - '0'; }
+				if (t_char >= 'a' && t_char <= 'f') { return t_char - 'a' + 10; }
+				if (t_char >= 'A' && t_char <= 'F') { return t_char - 'A' + 10; }
+				return -1;
+			}
+
+			bool read_hex4(unsigned int& t_code_unit) noexcept
+			{
+				if (m_end - m_current < 4)
+				{
+					return fail();
 				}
-				else // primitive
+				t_code_unit = 0;
+				for (int i = 0; i < 4; i++)
 				{
-					while (*it != ',' && *it != '}')
+					int digit = hex_digit(*m_current++);
+					if (digit < 0)
 					{
-						value.push_back(*it);
-						it++;
+						return fail();
 					}
+					t_code_unit = (t_code_unit << 4) | static_cast<unsigned int>(digit);
 				}
-				
-				std::vector<Node::JSON_Value> value_vector = get_value(value);
-				if (value_vector.size() > 1) // is an array
+				return true;
+			}
+
+			static void append_utf8(std::string& t_output, const unsigned int t_code_point)
+			{
+				if (t_code_point < 0x80)
 				{
-					temp_kvp_array.push_back(Node::JSON_KVP::make_kvp_array(format_value(key), value_vector));
+					t_output.push_back(static_cast<char>(t_code_point));
 				}
-				else // not an array
+				else if (t_code_point < 0x800)
 				{
-					temp_kvp_array.push_back(Node::JSON_KVP::make_kvp(key, get_value(value)[0]));
+					t_output.push_back(static_cast<char>(0xC0 | (t_code_point >> 6)));
+					t_output.push_back(static_cast<char>(0x80 | (t_code_point & 0x3F)));
 				}
-
-				if (it == t_object_input.end() || *it == '}')
+				else if (t_code_point < 0x10000)
 				{
-					break;
+					t_output.push_back(static_cast<char>(0xE0 | (t_code_point >> 12)));
+					t_output.push_back(static_cast<char>(0x80 | ((t_code_point >> 6) & 0x3F)));
+					t_output.push_back(static_cast<char>(0x80 | (t_code_point & 0x3F)));
 				}
 				else
 				{
-					key = "";
-					value = "";
-					it++;
+					t_output.push_back(static_cast<char>(0xF0 | (t_code_point >> 18)));
+					t_output.push_back(static_cast<char>(0x80 | ((t_code_point >> 12) & 0x3F)));
+					t_output.push_back(static_cast<char>(0x80 | ((t_code_point >> 6) & 0x3F)));
+					t_output.push_back(static_cast<char>(0x80 | (t_code_point & 0x3F)));
 				}
 			}
-			return temp_kvp_array;
-		}
-
-		/*
-		* Parses an array represesnted in a string.
-		* Like read_object() this is part of a recursive loop containing read_object(), read_array(), and get_value.
-		* @param t_array_input String to be parsed.
-		* @returns A vector of JSON_Value objects which is how this library represents an array.
-		*/
-		static std::vector<Node::JSON_Value> read_array(std::string t_array_input)
-		{
-			std::string::iterator it = t_array_input.begin();
-			std::vector<Node::JSON_Value> temp_value_array;
-			std::string value;
 
-			// skip any leading white space
-			while (*it == ' ') { it++; }
-			// return an empty value array if not reading an array
-			if (*it != '[') { return temp_value_array; }
-			// move iterator off opening bracket
-			it++;
-			// loop through values
-			while (*it != ']')
+			// Decodes the escape sequence at the current position. The iterator is on the backslash.
+			bool read_escape(std::string& t_output)
 			{
-				// read value
-				if (*it == '"') // string
+				m_current++;
+				if (m_current >= m_end)
 				{
-					do
-					{
-						value.push_back(*it);
-						it++;
-					} while (*it != '"');
-					// grab closing quote
-					value.push_back(*it);
-					it++;
+					return fail();
 				}
-				else if (*it == '\'') // also string
+				switch (*m_current++)
 				{
-					do
-					{
-						value.push_back(*it);
-						it++;
-					} while (*it != '\'');
-					// grab closing quote
-					value.push_back(*it);
-					it++;
-				}
-				else if (*it == '[') // array
+				case '"': t_output.push_back('"'); return true;
+				case '\'': t_output.push_back('\''); return true;
+				case '\\': t_output.push_back('\\'); return true;
+				case '/': t_output.push_back('/'); return true;
+				case 'b': t_output.push_back('\b'); return true;
+				case 'f': t_output.push_back('\f'); return true;
+				case 'n': t_output.push_back('\n'); return true;
+				case 'r': t_output.push_back('\r'); return true;
+				case 't': t_output.push_back('\t'); return true;
+				case 'u':
 				{
-					// Capture opening brace
-					value.push_back(*it);
-					it++;
-
-					int array_counter = 1;
-					while (array_counter != 0)
+					unsigned int code_point = 0;
+					if (!read_hex4(code_point))
 					{
-						if (*it == '[') // must track how many nested arrays we are reading 
-						{
-							array_counter++;
-						}
-						else if (*it == ']')
-						{
-							array_counter--;
-						}
-						value.push_back(*it);
-						it++;
+						return false;
 					}
-				}
-				// if opening brace is found read contents into buffer until closing brace
-				else if (*it == '{') // object
-				{
-					value.push_back(*it);
-					it++;
-
-					int object_counter = 1;
-					while (object_counter != 0)
+					if (code_point >= 0xD800 && code_point <= 0xDBFF) // high surrogate - must be followed by a low surrogate
 					{
-						if (*it == '{') // must track how many nested objects we are reading 
-						{
-							object_counter++;
-						}
-						else if (*it == '}')
+						unsigned int low_surrogate = 0;
+						if (!consume('\\') || !consume('u') || !read_hex4(low_surrogate) || low_surrogate < 0xDC00 || low_surrogate > 0xDFFF)
 						{
-							object_counter--;
+							return fail();
 						}
-						value.push_back(*it);
-						it++;
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
 					}
-
-					// append closing brace and move iterator forward
-					/*value.push_back('}');
-					it++;*/
-				}
-				else
-				{
-					while (*it != ',' && *it != ']')
+					else if (code_point >= 0xDC00 && code_point <= 0xDFFF) // unpaired low surrogate
 					{
-						value.push_back(*it);
-						it++;
+						return fail();
 					}
+					append_utf8(t_output, code_point);
+					return true;
 				}
-			
-		
-				std::vector<Node::JSON_Value> value_vector = get_value(value);
-				if (value_vector.size() > 1) // is an array
-				{
-					std::shared_ptr<std::vector<Node::JSON_Value>> nested_array(new std::vector<Node::JSON_Value>);
-					*nested_array = value_vector;
-					Node::JSON_Value temp_value;
-					temp_value.m_value_individual = nested_array;
-					temp_value_array.push_back(temp_value);
-				}
-				else // not an array
-				{
-					Node::JSON_Value temp_value = value_vector[0];
-					temp_value_array.push_back(temp_value);
-				}
-
-				if (*it == ']')
-				{
-					break;
-				}
-				else
-				{
-					value = "";
-					it++;
+				default:
+					m_current--;
+					return fail();
 				}
 			}
-			return temp_value_array;
+		};
+
+	private:
+
+		//*************************************** STATIC HELPER FUNCTIONS ***************************************\\
+
+		/*
+		* Heap allocates a JSON_Value object with the m_error_state flag set to true.
+		* Object must be deleted by the return, update, or delete function when checking for error state.
+		* @returns raw pointer
+		*/
+		static Node::JSON_Value* heap_allocate_error_value()
+		{
+			Node::JSON_Value* error_object(new Node::JSON_Value); 
+			error_object->m_error_state = true;
+			return error_object;
 		}
 
-		/**
-		* Determines the type and extracts the value of string input.
-		* This function also calls read_array() and read_object() which contain recursive calls to get_value().
-		* This enables us to fully traverse the potential recursive tree structure contained in a Node.
-		* @param t_string_input std::string input to extract the value from.
-		* @returns A JSON_Value object.
+		/*
+		* Heap allocates a JSON_KVP object with the m_error_state flag set to true.
+		* Object must be deleted by the return, update, or delete function when checking for error state.
+		* @returns raw pointer
 		*/
-		static std::vector<Node::JSON_Value> get_value(std::string t_value_input)
+		static Node::JSON_KVP* heap_allocate_error_kvp()
 		{
-			std::vector<Node::JSON_Value> temp_vector;
-			// format input
-			std::string value = format_value(t_value_input);
-			// get type of input
-			int type = check_type(value);
+			Node::JSON_KVP* error_object(new Node::JSON_KVP);
+			error_object->m_error_state = true;
+			return error_object;
+		}
 
-			switch (type)
-			{
-			case 0: // invalid input
+		// Same as format_value() but returns a view into t_input instead of a copy.
+		static std::string_view trim_spaces(const std::string_view t_input) noexcept
+		{
+			size_t begin = t_input.find_first_not_of(' ');
+			if (begin == std::string_view::npos)
 			{
-				return temp_vector;
-				break;
+				return std::string_view();
 			}
-			case 1: // integer
+			return t_input.substr(begin, t_input.find_last_not_of(' ') - begin + 1);
+		}
+
+		/**
+		* Removes leading and trailing white spaces from input.
+		* @param t_string_input String to be formatted
+		* @returns std::string
+		*/
+		const static std::string format_value(std::string t_string_input)
+		{
+			int len_counter = 0;
+			// count leading spaces if any
+			while (t_string_input[len_counter] == ' ')
 			{
-				Node::JSON_Value temp_value;
-				temp_value.m_value_individual = convert_to_int(value);
-				temp_vector.push_back(temp_value);
-				break;
+				len_counter++;
 			}
-			case 2: // double
+			// erase leading spaces if any found
+			if (len_counter > 0)
 			{
-				Node::JSON_Value temp_value;
-				temp_value.m_value_individual = convert_to_double(value);
-				temp_vector.push_back(temp_value);
-				break;
+				t_string_input.erase(0, len_counter);
 			}
-			case 3: // bool
+			// count trailing spaces if any
+			len_counter = 0;
+			for (int i = t_string_input.size() - 1; i > -1; i--)
 			{
-				Node::JSON_Value temp_value;
-				bool temp_bool;
-				if (value == "true")
+				if (t_string_input[i] == ' ')
 				{
-					temp_bool = true;
+					len_counter++;
 				}
 				else
 				{
-					temp_bool = false;
+					break;
 				}
-				temp_value.m_value_individual = temp_bool;
-				temp_vector.push_back(temp_value);
-				break;
-			}
-			case 4: // string
-			{
-				Node::JSON_Value temp_value;
-				remove_quotes(value);
-				temp_value.m_value_individual = value;
-				temp_vector.push_back(temp_value);
-				break;
-			}
-			case 5: // node
-			{
-				Node::JSON_Value temp_value;
-				std::shared_ptr<Node> temp_node_object(new Node);
-				temp_node_object->init_object("", read_object(value));
-				temp_value.m_value_individual = temp_node_object;
-				temp_vector.push_back(temp_value);
-				break;
 			}
-			case 6: // array
+			// erase trailing spaces if any found
+			if (len_counter > 0)
 			{
-				temp_vector = read_array(value);
-				break;
+				std::string::iterator it = t_string_input.end() - len_counter;
+				t_string_input.erase(it, t_string_input.end());
 			}
-			}	
-			return temp_vector;
+			return t_string_input;
 		}
 
-	public:
-		/**
-		* Parses string input using recursion to traverse a text JSON object and populate the JSON structure.
-		* @param t_json_input JSON formatted text input.
-		* @returns A JSON object
-		* @see get_value(), read_array(), read_object()
+		/*
+		* Converts an array and returns a "flat packed" JSON array. Arrays have the same form at every level,
+		* so nested arrays are converted by the same function. t_use_cache is passed on to the objects in the array,
+		* see write_node().
+		* @returns std::string
 		*/
-		static JSON parse(std::string t_json_input)
+		const static std::string convert_to_text(const std::vector<Node::JSON_Value>& t_input_array, const bool t_use_cache = false)
 		{
-			JSON temp_list;
-			temp_list.main_list.init_object("", read_object(json_remove_space(t_json_input)));
-			return temp_list;			
+			std::stringstream output;
+			output << "[";
+			bool first_element = true;
+			for (int i = 0; i < t_input_array.size(); i++)
+			{
+				const Node::JSON_Value& current_index = t_input_array[i];
+				if (current_index.m_removed)
+				{
+					continue;
+				}
+				std::string converted_value = "";
+				//determine type and convert to string
+				if (std::holds_alternative<int>(current_index.m_value_individual))
+				{
+					converted_value = std::to_string(std::get<int>(current_index.m_value_individual));
+				}
+				else if (std::holds_alternative<double>(current_index.m_value_individual))
+				{
+					converted_value = std::to_string(std::get<double>(current_index.m_value_individual));
+				}
+				else if (const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&current_index.m_value_individual))
+				{
+					converted_value = temp_number->m_text;
+				}
+				else if (std::holds_alternative<bool>(current_index.m_value_individual))
+				{
+					converted_value = std::to_string(std::get<bool>(current_index.m_value_individual));
+				}
+				else if (std::holds_alternative<std::string>(current_index.m_value_individual))
+				{
+					converted_value = std::get<std::string>(current_index.m_value_individual);
+				}
+				else if (std::holds_alternative<std::nullptr_t>(current_index.m_value_individual))
+				{
+					converted_value = "null";
+				}
+				else if (std::holds_alternative<std::shared_ptr<Node>>(current_index.m_value_individual))
+				{
+					write_node(*std::get<std::shared_ptr<Node>>(current_index.m_value_individual), converted_value, t_use_cache);
+				}
+				else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&current_index.m_value_individual))
+				{
+					converted_value = convert_to_text(*temp_array, t_use_cache);
+				}
+				// separate from the previous element, removed elements are skipped
+				if (!first_element)
+				{
+					output << ", ";
+				}
+				output << converted_value;
+				first_element = false;
+			}
+			output << ']';
+			return output.str();
+		}
+
+		// Returns true if the value is a number, whether it is stored as an int, a double, or its original text.
+		static bool is_number(const Node::JSON_Value& t_value) noexcept
+		{
+			return std::holds_alternative<int>(t_value.m_value_individual) || std::holds_alternative<double>(t_value.m_value_individual)
+				|| std::holds_alternative<Node::JSON_Value::Number>(t_value.m_value_individual);
 		}
 
 		/*
-		* Reads a file into a string and removes all newlines and carriage returns.
-		* @param t_file_path File path including file name and extension
-		* @returns std::string
+		* Reads an integer into t_output. Numbers kept as text are converted here, the first time they are read.
+		* @returns false if the value is not an integer or does not fit in T.
 		*/
-		static std::string read_file(std::string t_file_path)
+		template<typename T>
+		static bool read_integer(const Node::JSON_Value& t_value, T& t_output) noexcept
 		{
-			std::ifstream json_file;
-			std::string output_string;
-			std::stringstream buf;
+			if (const int* temp_int = std::get_if<int>(&t_value.m_value_individual))
+			{
+				t_output = static_cast<T>(*temp_int);
+				return true;
+			}
+			const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual);
+			if (temp_number == nullptr)
+			{
+				return false;
+			}
+			const char* number_begin = temp_number->m_text.data();
+			const char* number_end = number_begin + temp_number->m_text.size();
+			if (Scanner::is_floating_point(number_begin, number_end))
+			{
+				return false;
+			}
+			std::from_chars_result result = std::from_chars(number_begin, number_end, t_output);
+			return result.ec == std::errc() && result.ptr == number_end;
+		}
 
-			json_file.open(t_file_path);
-			if (!json_file.is_open())
+		/*
+		* Reads a double into t_output. As when numbers were converted during parsing, integers are only read as
+		* doubles if they do not fit in an int.
+		* @returns false if the value is not a double.
+		*/
+		static bool read_floating(const Node::JSON_Value& t_value, double& t_output) noexcept
+		{
+			if (const double* temp_double = std::get_if<double>(&t_value.m_value_individual))
 			{
-				return output_string;
+				t_output = *temp_double;
+				return true;
+			}
+			int temp_int = 0;
+			const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual);
+			if (temp_number == nullptr || read_integer(t_value, temp_int))
+			{
+				return false;
 			}
+			const char* number_end = temp_number->m_text.data() + temp_number->m_text.size();
+			std::from_chars_result result = std::from_chars(temp_number->m_text.data(), number_end, t_output);
+			return result.ec == std::errc() && result.ptr == number_end;
+		}
 
-			buf << json_file.rdbuf();
-			output_string = buf.str();
-			output_string.erase(std::remove(output_string.begin(), output_string.end(), '\n'), output_string.end()); // remove newlines
-			output_string.erase(std::remove(output_string.begin(), output_string.end(), '\r'), output_string.end());
-			return output_string;
+		// Returns the original text of a parsed number, the text serialize() writes for other numbers, or "" otherwise.
+		static std::string number_text(const Node::JSON_Value& t_value)
+		{
+			if (const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual))
+			{
+				return temp_number->m_text;
+			}
+			if (const int* temp_int = std::get_if<int>(&t_value.m_value_individual))
+			{
+				return std::to_string(*temp_int);
+			}
+			if (const double* temp_double = std::get_if<double>(&t_value.m_value_individual))
+			{
+				return std::to_string(*temp_double);
+			}
+			return "";
 		}
 
-		bool is_empty()
+		//************************************************ CREATE ***********************************************\\
+
+	public:
+		/*
+		* Base class for handlers passed to parse_events(). Derive from it and hide the methods for the events you
+		* are interested in; the others do nothing. Calls are resolved at compile time, so the methods do not need
+		* to be virtual. Returning false from any method stops parsing immediately.
+		* A handler may also provide 'bool number_text(const char* t_begin, const char* t_end)'. If it does, numbers in
+		* standard JSON form are reported with their original text instead of being converted to int_value() or
+		* double_value().
+		*/
+		struct Event_Handler
 		{
-			if (std::holds_alternative<std::monostate>(main_list.m_kvp))
+			bool start_object() { return true; }
+			bool key(const std::string& /* t_key */) { return true; }
+			bool end_object() { return true; }
+			bool start_array() { return true; }
+			bool end_array() { return true; }
+			bool int_value(const int /* t_value */) { return true; }
+			bool double_value(const double /* t_value */) { return true; }
+			bool bool_value(const bool /* t_value */) { return true; }
+			bool string_value(const std::string& /* t_value */) { return true; }
+			bool null_value() { return true; }
+
+			// Called after key(). Return true to skip the key's value without reporting any events for it.
+			bool skip_next_value() { return false; }
+		};
+
+	private:
+		template<typename Handler, typename = void>
+		struct has_number_text : std::false_type {};
+
+		template<typename Handler>
+		struct has_number_text<Handler, std::void_t<decltype(std::declval<Handler&>().number_text(static_cast<const char*>(nullptr), static_cast<const char*>(nullptr)))>> : std::true_type {};
+
+		// Reads an object key and the colon that follows it, then reports the key to the handler and asks whether
+		// its value should be skipped.
+		template<typename Handler>
+		static bool scan_key(Scanner& t_scanner, Handler& t_handler, std::string& t_buffer, bool& t_stopped, bool& t_skip)
+		{
+			t_scanner.skip_whitespace();
+			if (!t_scanner.read_key(t_buffer))
 			{
-				return true;
+				return false;
 			}
-			else
+			t_scanner.skip_whitespace();
+			if (!t_scanner.consume(':'))
 			{
-				std::vector<Node::JSON_KVP>* main_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&main_list.m_kvp);
-				if (main_vector_ptr == nullptr)
+				return t_scanner.fail();
+			}
+			t_stopped = !t_handler.key(t_buffer);
+			t_skip = !t_stopped && t_handler.skip_next_value();
+			return true;
+		}
+
+		/*
+		* Reads a number and reports it as an int if it is an integer that fits in one, otherwise as a double.
+		* Handlers with number_text() get the text of numbers in standard form without any conversion.
+		*/
+		template<typename Handler>
+		static bool scan_number(Scanner& t_scanner, Handler& t_handler, bool& t_stopped)
+		{
+			const char* number_begin = nullptr;
+			const char* number_end = nullptr;
+			if (!t_scanner.read_number(number_begin, number_end))
+			{
+				return false;
+			}
+			if constexpr (has_number_text<Handler>::value)
+			{
+				// other forms accepted by read_number, such as leading zeros, are converted as before
+				const char* number_it = number_begin;
+				if (validate_number(number_it, number_end) && number_it == number_end)
 				{
+					t_stopped = !t_handler.number_text(number_begin, number_end);
 					return true;
 				}
-				else if (main_vector_ptr->size() > 0)
+			}
+			if (!Scanner::is_floating_point(number_begin, number_end))
+			{
+				int int_value = 0;
+				std::from_chars_result result = std::from_chars(number_begin, number_end, int_value);
+				if (result.ec == std::errc() && result.ptr == number_end)
 				{
-					return false;
+					t_stopped = !t_handler.int_value(int_value);
+					return true;
 				}
 			}
+			double double_value = 0;
+			std::from_chars_result result = std::from_chars(number_begin, number_end, double_value);
+			if (result.ec != std::errc() || result.ptr != number_end)
+			{
+				t_scanner.m_current = number_begin;
+				return t_scanner.fail();
+			}
+			t_stopped = !t_handler.double_value(double_value);
+			return true;
 		}
 
-		//************************************************ READ ************************************************\\
+		// Working buffers of scan_events(). A Parser keeps them between calls so their capacity is reused.
+		struct Scan_Buffers
+		{
+			std::vector<char> m_container_stack;
+			std::string m_string;
+		};
+
+		template<typename Handler>
+		static bool scan_events(Scanner& t_scanner, Handler& t_handler)
+		{
+			Scan_Buffers buffers;
+			return scan_events(t_scanner, t_handler, buffers);
+		}
 
 		/*
-		* Returns an int contained in an array or -1 on error.
-		* @param t_input Array to be evaluated (usually obtained with an())
-		* @returns int
+		* Event loop shared by parse_events() and parse(). Nesting is tracked with an explicit stack instead of
+		* recursion so deeply nested input cannot overflow the call stack.
+		* @returns false on a syntax error, true when the input was read completely or the handler stopped.
 		*/
-		static int r_int(const Node::JSON_Value& t_input)
-		{			
-			if (t_input.m_error_state == true) 
-			{
-				delete& t_input;
-				return -1;
-			}
-			int output = -1;
-			if (std::holds_alternative<int>(t_input.m_value_individual))
+		template<typename Handler>
+		static bool scan_events(Scanner& t_scanner, Handler& t_handler, Scan_Buffers& t_buffers)
+		{
+			std::vector<char>& container_stack = t_buffers.m_container_stack;
+			std::string& buffer = t_buffers.m_string;
+			container_stack.clear();
+			bool stopped = false;
+			bool skip = false;
+
+			while (true)
 			{
-				output = std::get<int>(t_input.m_value_individual);
+				// read a value
+				t_scanner.skip_whitespace();
+				char first = t_scanner.peek();
+				bool value_complete = true;
+				if (skip)
+				{
+					skip = false;
+					if (!t_scanner.skip_value()) { return false; }
+				}
+				else if (first == '{')
+				{
+					t_scanner.m_current++;
+					if (!t_handler.start_object()) { return true; }
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume('}'))
+					{
+						if (!t_handler.end_object()) { return true; }
+					}
+					else
+					{
+						container_stack.push_back('{');
+						if (!scan_key(t_scanner, t_handler, buffer, stopped, skip)) { return false; }
+						value_complete = false;
+					}
+				}
+				else if (first == '[')
+				{
+					t_scanner.m_current++;
+					if (!t_handler.start_array()) { return true; }
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume(']'))
+					{
+						if (!t_handler.end_array()) { return true; }
+					}
+					else
+					{
+						container_stack.push_back('[');
+						value_complete = false;
+					}
+				}
+				else if (first == '"' || first == '\'')
+				{
+					if (!t_scanner.read_string(buffer)) { return false; }
+					stopped = !t_handler.string_value(buffer);
+				}
+				else if (t_scanner.consume_literal("true"))
+				{
+					stopped = !t_handler.bool_value(true);
+				}
+				else if (t_scanner.consume_literal("false"))
+				{
+					stopped = !t_handler.bool_value(false);
+				}
+				else if (t_scanner.consume_literal("null"))
+				{
+					stopped = !t_handler.null_value();
+				}
+				else if (!scan_number(t_scanner, t_handler, stopped))
+				{
+					return false;
+				}
+				if (stopped)
+				{
+					return true;
+				}
+				if (!value_complete)
+				{
+					continue;
+				}
+
+				// close any containers that end after this value, then move to the next value
+				while (true)
+				{
+					if (container_stack.empty())
+					{
+						t_scanner.skip_whitespace();
+						return t_scanner.at_end() ? true : t_scanner.fail();
+					}
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume(','))
+					{
+						if (container_stack.back() == '{')
+						{
+							if (!scan_key(t_scanner, t_handler, buffer, stopped, skip)) { return false; }
+							if (stopped) { return true; }
+						}
+						break;
+					}
+					if (container_stack.back() == '{' && t_scanner.consume('}'))
+					{
+						container_stack.pop_back();
+						if (!t_handler.end_object()) { return true; }
+					}
+					else if (container_stack.back() == '[' && t_scanner.consume(']'))
+					{
+						container_stack.pop_back();
+						if (!t_handler.end_array()) { return true; }
+					}
+					else
+					{
+						return t_scanner.fail();
+					}
+				}
 			}
-			return output;
 		}
+
 		/*
-		* Returns an int contained in an object or -1 on error.
-		* @param t_input Object to be evaluated (usually obtained with dn())
-		* @returns int
+		* Handler used by parse() to build the JSON structure from parse events.
+		* Containers that are still open are kept on a stack and moved into their parent when they are closed.
+		* Arrays are stored by value in a JSON_Value at every level, nested objects are heap allocated.
+		* String values keep their surrounding quotes. When a Storage_Pool is set, vectors, strings and nodes are
+		* taken from it before new ones are allocated.
 		*/
-		static int r_int(const Node::JSON_KVP& t_input)
+		class Document_Builder : public Event_Handler
+		{
+		private:
+			struct Frame
+			{
+				bool m_is_object = true;
+				std::string m_key;
+				std::vector<Node::JSON_KVP> m_members;
+				std::vector<Node::JSON_Value> m_elements;
+			};
+
+			Node* m_root = nullptr;
+			Storage_Pool* m_pool = nullptr;
+			std::vector<Frame> m_stack;
+			size_t m_depth = 0;
+
+		public:
+			Document_Builder() = default;
+			Document_Builder(Node& t_root) : m_root(&t_root) {}
+
+			// Starts a new document, keeping the frames of the previous one.
+			void reset(Node& t_root, Storage_Pool* t_pool)
+			{
+				m_root = &t_root;
+				m_pool = t_pool;
+				m_depth = 0;
+			}
+
+			bool start_object() { return open(true); }
+			bool start_array() { return open(false); }
+			bool key(const std::string& t_key)
+			{
+				std::string& key = m_stack[m_depth - 1].m_key;
+				if (m_pool != nullptr && key.capacity() < t_key.size())
+				{
+					key = Storage_Pool::take(m_pool->m_strings);
+				}
+				key = t_key;
+				return true;
+			}
+
+			bool end_object()
+			{
+				Frame& frame = m_stack[--m_depth];
+				if (m_depth == 0)
+				{
+					m_root->m_object_key.clear();
+					m_root->m_kvp = std::move(frame.m_members);
+					link_children(*m_root);
+					return true;
+				}
+				std::shared_ptr<Node> temp_node_object = m_pool != nullptr ? Storage_Pool::take(m_pool->m_nodes) : nullptr;
+				if (temp_node_object == nullptr)
+				{
+					temp_node_object.reset(new Node);
+				}
+				temp_node_object->m_kvp = std::move(frame.m_members);
+				link_children(*temp_node_object);
+				Node::JSON_Value temp_value;
+				temp_value.m_value_individual = std::move(temp_node_object);
+				return add_value(std::move(temp_value));
+			}
+
+			bool end_array()
+			{
+				Frame& frame = m_stack[--m_depth];
+				return add_scalar(std::move(frame.m_elements));
+			}
+
+			bool int_value(const int t_value) { return add_scalar(t_value); }
+			bool double_value(const double t_value) { return add_scalar(t_value); }
+			bool number_text(const char* t_begin, const char* t_end)
+			{
+				Node::JSON_Value::Number number{ take_string() };
+				number.m_text.assign(t_begin, t_end);
+				return add_scalar(std::move(number));
+			}
+			bool bool_value(const bool t_value) { return add_scalar(t_value); }
+			bool null_value() { return add_scalar(nullptr); }
+			bool string_value(const std::string& t_value)
+			{
+				std::string quoted_value = take_string();
+				quoted_value.reserve(t_value.size() + 2);
+				write_escaped_string(quoted_value, t_value);
+				return add_scalar(std::move(quoted_value));
+			}
+
+		private:
+			// Frames are reused between containers at the same depth to keep their buffers allocated.
+			bool open(const bool t_is_object)
+			{
+				if (m_depth == m_stack.size())
+				{
+					m_stack.emplace_back();
+				}
+				Frame& frame = m_stack[m_depth++];
+				frame.m_is_object = t_is_object;
+				frame.m_key.clear();
+				frame.m_members.clear();
+				frame.m_elements.clear();
+				// the vectors of a frame are moved into the document when it closes
+				if (m_pool != nullptr && t_is_object && frame.m_members.capacity() == 0)
+				{
+					frame.m_members = Storage_Pool::take(m_pool->m_members);
+				}
+				else if (m_pool != nullptr && !t_is_object && frame.m_elements.capacity() == 0)
+				{
+					frame.m_elements = Storage_Pool::take(m_pool->m_elements);
+				}
+				return true;
+			}
+
+			std::string take_string()
+			{
+				return m_pool != nullptr ? Storage_Pool::take(m_pool->m_strings) : std::string();
+			}
+
+			template<typename T>
+			bool add_scalar(T&& t_value)
+			{
+				Node::JSON_Value temp_value;
+				temp_value.m_value_individual = std::forward<T>(t_value);
+				return add_value(std::move(temp_value));
+			}
+
+			bool add_kvp(Node::JSON_KVP&& t_kvp)
+			{
+				if (m_depth == 0)
+				{
+					std::vector<Node::JSON_KVP> root_vector = m_pool != nullptr ? Storage_Pool::take(m_pool->m_members) : std::vector<Node::JSON_KVP>();
+					root_vector.push_back(std::move(t_kvp));
+					m_root->m_kvp = std::move(root_vector);
+					link_children(*m_root);
+					return true;
+				}
+				Frame& parent = m_stack[m_depth - 1];
+				t_kvp.m_key = std::move(parent.m_key);
+				parent.m_members.push_back(std::move(t_kvp));
+				return true;
+			}
+
+			bool add_value(Node::JSON_Value&& t_value)
+			{
+				if (m_depth > 0 && !m_stack[m_depth - 1].m_is_object)
+				{
+					m_stack[m_depth - 1].m_elements.push_back(std::move(t_value));
+					return true;
+				}
+				Node::JSON_KVP temp_kvp;
+				temp_kvp.m_value = std::move(t_value);
+				return add_kvp(std::move(temp_kvp));
+			}
+		};
+
+
+	public:
+		/*
+		* Scans JSON text and reports each token to a handler as it is read without building a JSON structure.
+		* Memory use is constant apart from the current string and the nesting depth, so this can process inputs of
+		* any size. Strings are passed with their quotes removed and escape sequences decoded. Integers that do not
+		* fit in an int are reported as doubles.
+		* @param t_json_input JSON formatted text input.
+		* @param t_handler Object providing the methods of Event_Handler.
+		* @returns false if a syntax error was found. Stopping early from the handler is not an error.
+		*/
+		template<typename Handler>
+		static bool parse_events(const std::string& t_json_input, Handler& t_handler)
+		{
+			Scanner scanner(t_json_input.data(), t_json_input.data() + t_json_input.size());
+			return scan_events(scanner, t_handler);
+		}
+
+		/**
+		* Parses string input and populates the JSON structure. This is parse_events() with a handler that builds
+		* the JSON structure.
+		* @param t_json_input JSON formatted text input.
+		* @returns A JSON object, or an empty JSON object if the input contains a syntax error.
+		* @see parse_events()
+		*/
+		static JSON parse(const std::string& t_json_input)
+		{
+			JSON temp_list;
+			Document_Builder builder(temp_list.main_list);
+			if (!parse_events(t_json_input, builder))
+			{
+				temp_list.main_list.m_kvp = std::monostate();
+			}
+			return temp_list;
+		}
+
+		/*
+		* Reads a file into a string and removes all newlines and carriage returns.
+		* @param t_file_path File path including file name and extension
+		* @returns std::string
+		*/
+		static std::string read_file(std::string t_file_path)
+		{
+			std::ifstream json_file;
+			std::string output_string;
+			std::stringstream buf;
+
+			json_file.open(t_file_path);
+			if (!json_file.is_open())
+			{
+				return output_string;
+			}
+
+			buf << json_file.rdbuf();
+			output_string = buf.str();
+			output_string.erase(std::remove(output_string.begin(), output_string.end(), '\n'), output_string.end()); // remove newlines
+			output_string.erase(std::remove(output_string.begin(), output_string.end(), '\r'), output_string.end());
+			return output_string;
+		}
+
+		bool is_empty()
+		{
+			if (std::holds_alternative<std::monostate>(main_list.m_kvp))
+			{
+				return true;
+			}
+			else
+			{
+				std::vector<Node::JSON_KVP>* main_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&main_list.m_kvp);
+				if (main_vector_ptr == nullptr)
+				{
+					return true;
+				}
+				return std::all_of(main_vector_ptr->begin(), main_vector_ptr->end(), [](const Node::JSON_KVP& t_kvp) { return t_kvp.m_removed; });
+			}
+		}
+
+		//************************************************ READ ************************************************\\
+
+		/*
+		* Returns an int contained in an array or -1 on error.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns int
+		*/
+		static int r_int(const Node::JSON_Value& t_input)
+		{			
+			if (t_input.m_error_state == true) 
+			{
+				delete& t_input;
+				return -1;
+			}
+			int output = -1;
+			if (!read_integer(t_input, output))
+			{
+				output = -1;
+			}
+			return output;
+		}
+		/*
+		* Returns an int contained in an object or -1 on error.
+		* @param t_input Object to be evaluated (usually obtained with dn())
+		* @returns int
+		*/
+		static int r_int(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return -1;
+			}
+			int output = -1;
+			if (!read_integer(t_input.m_value, output))
+			{
+				return -1;
+			}
+			return output;
+		}
+		/*
+		* Returns a double contained in an array or -1 on error.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns double
+		*/
+		static double r_double(const Node::JSON_Value& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return -1;
+			}
+			double output = -1;
+			if (!read_floating(t_input, output))
+			{
+				output = -1;
+			}
+			return output;
+		}
+		/*
+		* Returns a double contained in an object or -1 on error.
+		* @param t_input Obejct to be evaluated (usually obtained with dn())
+		* @returns double
+		*/
+		static double r_double(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return -1;
+			}
+			double output = -1;
+			if (!read_floating(t_input.m_value, output))
+			{
+				return -1;
+			}
+			return output;
+		}
+		/*
+		* Returns a 64 bit integer contained in an array or -1 on error. Unlike r_int() this reads integers that
+		* do not fit in an int without going through a double, so large IDs keep every digit.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns long long
+		*/
+		static long long r_int64(const Node::JSON_Value& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return -1;
+			}
+			long long output = -1;
+			if (!read_integer(t_input, output))
+			{
+				output = -1;
+			}
+			return output;
+		}
+		/*
+		* Returns a 64 bit integer contained in an object or -1 on error.
+		* @param t_input Object to be evaluated (usually obtained with dn())
+		* @returns long long
+		*/
+		static long long r_int64(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return -1;
+			}
+			long long output = -1;
+			if (!read_integer(t_input.m_value, output))
+			{
+				return -1;
+			}
+			return output;
+		}
+		/*
+		* Returns the text of a number contained in an array, or an empty string on error. Parsed numbers are
+		* returned exactly as they were written, so decimals can be read without rounding through a double.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns std::string
+		*/
+		static std::string r_number(const Node::JSON_Value& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return "";
+			}
+			return number_text(t_input);
+		}
+		/*
+		* Returns the text of a number contained in an object, or an empty string on error.
+		* @param t_input Object to be evaluated (usually obtained with dn())
+		* @returns std::string
+		*/
+		static std::string r_number(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return "";
+			}
+			return number_text(t_input.m_value);
+		}
+		/*
+		* Returns a bool contained in an array or false on error.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns bool
+		*/
+		static bool r_bool(const Node::JSON_Value& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return false;
+			}
+			bool output = false;
+			if (std::holds_alternative<bool>(t_input.m_value_individual))
+			{
+				output = std::get<bool>(t_input.m_value_individual);
+			}
+			return output;
+		}
+		/*
+		* Returns a bool contained in an object or false on error.
+		* @param t_input Object to be evaluated (usually obtained with dn())
+		* @returns bool
+		*/
+		static bool r_bool(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return false;
+			}
+			bool output = false;
+			if (std::holds_alternative<bool>(t_input.m_value.m_value_individual))
+			{
+				output = std::get<bool>(t_input.m_value.m_value_individual);
+			}
+			else
+			{
+				return false;
+			}
+			return output;
+		}
+		/*
+		* Returns a string contained in an array or an empty string on error.
+		* @param t_input Array to be evaluated (usually obtained with an())
+		* @returns std::string
+		*/
+		static std::string r_string(const Node::JSON_Value& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return "";
+			}
+			std::string output = "";
+			if (std::holds_alternative<std::string>(t_input.m_value_individual))
+			{
+				output = std::get<std::string>(t_input.m_value_individual);
+			}
+			return output;
+		}
+		/*
+		* Returns a string contained in an object or an empty string on error.
+		* @param t_input Object to be evaluated (usually obtained with dn())
+		* @returns std::string
+		*/
+		static std::string r_string(const Node::JSON_KVP& t_input)
+		{
+			if (t_input.m_error_state == true)
+			{
+				delete& t_input;
+				return "";
+			}
+			std::string output = "";
+			if (std::holds_alternative<std::string>(t_input.m_value.m_value_individual))
+			{
+				output = std::get<std::string>(t_input.m_value.m_value_individual);
+			}
+			return output;
+		}
+
+		// ****NODE ACCESS****
+
+		/*
+		* Method that returns a reference to the JSON_Value object located at a specific index in an array.
+		* A version of this exists in three classes: JSON, JSON_KVP, and JSON_Value. All methods have the
+		* same name to facilitate ease of use by the end user. Calls to an() and dn() can be chained in a similar
+		* manner to using array notation and dot notation when accessing JSON objects in Javascript. This is used
+		* primarily to provide a specific array index to the return, update, or delete methods.
+		* @returns JSON_Value&
+		*/
+		Node::JSON_Value& an(int t_index)
+		{
+			std::vector<Node::JSON_KVP>* main_list_kvp = std::get_if<std::vector<Node::JSON_KVP>>(&main_list.m_kvp);
+			if (main_list_kvp == nullptr)
+			{
+				Node::JSON_Value* error_value = heap_allocate_error_value();
+				return *error_value;
+			}
+			
+			std::vector<Node::JSON_Value> *temp_kvp_array = main_list_kvp->empty() ? nullptr : std::get_if<std::vector<Node::JSON_Value>>(&(*main_list_kvp)[0].m_value.m_value_individual);
+
+
+			if (temp_kvp_array == nullptr || t_index < 0 || static_cast<size_t>(t_index) >= temp_kvp_array->size() || (*temp_kvp_array)[t_index].m_removed)
+			{
+				Node::JSON_Value* error_value = heap_allocate_error_value();
+				return *error_value;
+			}
+			else
+			{
+				Node::JSON_Value& temp_value = (*temp_kvp_array)[t_index];
+				return temp_value;
+			}		
+
+		}
+
+		/*
+		* Method that returns a reference to a JSON_KVP object located inside of a JSON object. A version of this
+		* method exists across three classes: JSON, JSON_KVP, and JSON_Value. All methods have the
+		* same name to facilitate ease of use by the end user. Calls to an() and dn() can be chained in a similar
+		* manner to using array notation and dot notation when accessing JSON objects in Javascript. This is used
+		* primarily to provide a specific object to the return, update, or delete methods.
+		* @returns JSON_KVP&
+		*/
+		Node::JSON_KVP& dn(const std::string& t_key)
+		{
+			return main_list.find_by_key(t_key);
+		}
+
+		/*
+		* Key for dn() that is looked up without building a std::string. The "name"_key literal from
+		* JSONator::literals makes one whose length is known at compile time:
+		*
+		*	using namespace JSONator::literals;
+		*	int id = JSON::r_int(obj.dn("user"_key).dn("id"_key));
+		*/
+		class Key
+		{
+		public:
+			std::string_view m_text;
+
+			constexpr explicit Key(const std::string_view t_text) noexcept : m_text(t_text) {}
+		};
+
+		Node::JSON_KVP& dn(const Key& t_key)
+		{
+			return main_list.find_by_key(t_key.m_text);
+		}
+
+		//************************************************ UPDATE ***********************************************\\
+
+		// Updates an objects key
+		void static update_key(const std::string t_new_key, Node::JSON_KVP& t_object) noexcept
+		{
+			if (t_object.m_error_state == false)
+			{
+				t_object.m_key = t_new_key;
+				mark_dirty(t_object.m_owner);
+				// register the new key with the document's key index, the old key's entry is dropped when next visited
+				Node* temp_root = find_root(t_object.m_owner);
+				if (temp_root != nullptr && temp_root->m_key_index != nullptr)
+				{
+					std::vector<Node::JSON_KVP>& temp_kvp_array = std::get<std::vector<Node::JSON_KVP>>(t_object.m_owner->m_kvp);
+					index_key(*temp_root->m_key_index, *t_object.m_owner, t_new_key, static_cast<size_t>(&t_object - temp_kvp_array.data()));
+				}
+			}
+			else
+			{
+				delete &t_object;
+			}
+		}
+
+		// Overloaded method to update an objects value to a new value of any type
+		void static update_value(const int t_new_value, Node::JSON_KVP& t_object) noexcept
+		{
+			if (t_object.m_error_state == false)
+			{
+				t_object.m_value.m_value_individual = t_new_value;
+				mark_dirty(t_object.m_owner);
+			}
+			else
+			{
+				delete& t_object;
+			}
+		}
+		void static update_value(const double t_new_value, Node::JSON_KVP& t_object) noexcept
+		{
+			if (t_object.m_error_state == false)
+			{
+				t_object.m_value.m_value_individual = t_new_value;
+				mark_dirty(t_object.m_owner);
+			}
+			else
+			{
+				delete& t_object;
+			}
+		}
+		void static update_value(const bool t_new_value, Node::JSON_KVP& t_object) noexcept
+		{
+			if (t_object.m_error_state == false)
+			{
+				t_object.m_value.m_value_individual = t_new_value;
+				mark_dirty(t_object.m_owner);
+			}
+			else
+			{
+				delete& t_object;
+			}
+		}
+		void static update_value(const std::string t_new_value, Node::JSON_KVP& t_object) noexcept
+		{
+			if (t_object.m_error_state == false)
+			{
+				t_object.m_value.m_value_individual = t_new_value;
+				mark_dirty(t_object.m_owner);
+			}
+			else
+			{
+				delete& t_object;
+			}
+		}
+		void static update_value(const int t_new_value, Node::JSON_Value& t_value) noexcept
+		{
+			if (t_value.m_error_state == false)
+			{
+				t_value.m_value_individual = t_new_value;
+				mark_dirty(t_value.m_owner);
+			}
+			else
+			{
+				delete& t_value;
+			}
+		}
+		void static update_value(const double t_new_value, Node::JSON_Value& t_value) noexcept
+		{
+			if (t_value.m_error_state == false)
+			{
+				t_value.m_value_individual = t_new_value;
+				mark_dirty(t_value.m_owner);
+			}
+			else
+			{
+				delete& t_value;
+			}
+		}
+		void static update_value(const bool t_new_value, Node::JSON_Value& t_value) noexcept
+		{
+			if (t_value.m_error_state == false)
+			{
+				t_value.m_value_individual = t_new_value;
+				mark_dirty(t_value.m_owner);
+			}
+			else
+			{
+				delete& t_value;
+			}
+		}
+		void static update_value(const std::string t_new_value, Node::JSON_Value& t_value) noexcept
+		{
+			if (t_value.m_error_state == false)
+			{
+				t_value.m_value_individual = t_new_value;
+				mark_dirty(t_value.m_owner);
+			}
+			else
+			{
+				delete& t_value;
+			}
+		}
+
+		//************************************************ DELETE ***********************************************\\
+
+		// Traverses the entire JSON structure and deletes the first instance of the key that it finds.
+		// Uses the key index instead of traversing when one is enabled.
+		void remove_first_found(const std::string t_key)
+		{
+			if (m_key_index != nullptr)
+			{
+				remove_first_indexed(t_key);
+				return;
+			}
+			std::pair<std::vector<Node::JSON_KVP>*, int> vector_reference_and_index = main_list.recursive_find_parent_vector_and_index(t_key);
+			if (vector_reference_and_index.first != nullptr)
+			{
+				std::vector<Node::JSON_KVP>* temp_vector_ptr = vector_reference_and_index.first;
+				int vector_index = vector_reference_and_index.second;
+				mark_dirty((*temp_vector_ptr)[vector_index].m_owner);
+				if (main_list.m_defer_removals)
+				{
+					(*temp_vector_ptr)[vector_index].m_removed = true;
+				}
+				else
+				{
+					temp_vector_ptr->erase(temp_vector_ptr->begin() + vector_index);
+				}
+			}
+		}
+
+		// Overloaded method that deletes an index from an array or nested array
+		void static remove_from_array(Node::JSON_Value& t_array, const int t_index)
+		{
+			remove_from_array(t_array, std::vector<int>{ t_index });
+		}
+		void static remove_from_array(Node::JSON_KVP& t_object, const int t_index)
+		{
+			remove_from_array(t_object, std::vector<int>{ t_index });
+		}
+
+		/*
+		* Overloaded method that deletes several indices from an array or nested array in a single pass.
+		* Indices refer to positions before any of them are removed. Indices out of range are ignored.
+		*/
+		void static remove_from_array(Node::JSON_Value& t_array, const std::vector<int>& t_indices)
+		{
+			if (t_array.m_error_state == false)
+			{
+				std::vector<Node::JSON_Value>* temp_array_ptr = std::get_if<std::vector<Node::JSON_Value>>(&t_array.m_value_individual);
+				if (temp_array_ptr != nullptr)
+				{
+					remove_indices(*temp_array_ptr, t_indices, removals_deferred(t_array.m_owner));
+					mark_dirty(t_array.m_owner);
+				}
+			}
+			else
+			{
+				delete& t_array;
+			}
+		}
+		void static remove_from_array(Node::JSON_KVP& t_object, const std::vector<int>& t_indices)
+		{
+			if (t_object.m_error_state == false)
+			{
+				remove_from_array(t_object.m_value, t_indices);
+			}
+			else
+			{
+				delete& t_object;
+			}
+		}
+
+		// Deletes a key value pair from an object
+		void static remove_from_object(Node::JSON_KVP& t_object, const std::string t_key)
+		{
+			std::vector<Node::JSON_KVP>* temp_object_vector_ptr = get_object_members(t_object);
+			if (temp_object_vector_ptr != nullptr)
+			{
+				for (Node::JSON_KVP& current_object : *temp_object_vector_ptr)
+				{
+					if (!current_object.m_removed && current_object.m_key == t_key)
+					{
+						current_object.m_removed = true;
+						break;
+					}
+				}
+				if (!removals_deferred(t_object.m_owner))
+				{
+					erase_removed(*temp_object_vector_ptr);
+				}
+			}
+		}
+
+		// Deletes every key value pair whose key is in t_keys from an object in a single pass.
+		void static remove_from_object(Node::JSON_KVP& t_object, const std::vector<std::string>& t_keys)
+		{
+			std::vector<Node::JSON_KVP>* temp_object_vector_ptr = get_object_members(t_object);
+			if (temp_object_vector_ptr != nullptr)
+			{
+				std::unordered_set<std::string> keys(t_keys.begin(), t_keys.end());
+				for (Node::JSON_KVP& current_object : *temp_object_vector_ptr)
+				{
+					if (keys.count(current_object.m_key) > 0)
+					{
+						current_object.m_removed = true;
+					}
+				}
+				if (!removals_deferred(t_object.m_owner))
+				{
+					erase_removed(*temp_object_vector_ptr);
+				}
+			}
+		}
+
+		/*
+		* Defers removals until end_removals() is called. While removals are deferred the delete methods only mark
+		* the removed pairs and array elements, so array indices keep referring to the positions they had before the
+		* first removal. Marked entries are ignored by the read, search, and serialize methods.
+		*/
+		void begin_removals() noexcept
+		{
+			main_list.m_defer_removals = true;
+		}
+
+		// Drops every entry marked since begin_removals() in a single pass over the JSON structure.
+		void end_removals()
+		{
+			main_list.m_defer_removals = false;
+			compact_node(main_list);
+		}
+
+	private:
+		// Returns true if t_owner belongs to a document whose removals are deferred.
+		static bool removals_deferred(Node* t_owner) noexcept
+		{
+			Node* temp_root = find_root(t_owner);
+			return temp_root != nullptr && temp_root->m_defer_removals;
+		}
+
+		/*
+		* Returns the members of the object held by t_object and marks the object as changed, or returns nullptr if
+		* t_object does not hold an object. Deletes t_object if it is an error object.
+		*/
+		static std::vector<Node::JSON_KVP>* get_object_members(Node::JSON_KVP& t_object)
+		{
+			if (t_object.m_error_state)
+			{
+				delete& t_object;
+				return nullptr;
+			}
+			std::shared_ptr<Node>* temp_node_ptr = std::get_if<std::shared_ptr<Node>>(&t_object.m_value.m_value_individual);
+			if (temp_node_ptr == nullptr)
+			{
+				return nullptr;
+			}
+			mark_dirty(temp_node_ptr->get());
+			return std::get_if<std::vector<Node::JSON_KVP>>(&(*temp_node_ptr)->m_kvp);
+		}
+
+		static void remove_indices(std::vector<Node::JSON_Value>& t_array, const std::vector<int>& t_indices, const bool t_defer)
+		{
+			for (int index : t_indices)
+			{
+				if (index >= 0 && static_cast<size_t>(index) < t_array.size())
+				{
+					t_array[index].m_removed = true;
+				}
+			}
+			if (!t_defer)
+			{
+				erase_removed(t_array);
+			}
+		}
+
+		// Erases the marked entries of a vector of pairs or values, moving each kept entry at most once.
+		template<typename T>
+		static void erase_removed(std::vector<T>& t_entries)
+		{
+			t_entries.erase(std::remove_if(t_entries.begin(), t_entries.end(), [](const T& t_entry) { return t_entry.m_removed; }), t_entries.end());
+		}
+
+		static void compact_node(Node& t_node)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			erase_removed(*temp_kvp_array);
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				compact_value(kvp.m_value);
+			}
+		}
+
+		static void compact_value(Node::JSON_Value& t_value)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				compact_node(**temp_node);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				erase_removed(*temp_array);
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					compact_value(element);
+				}
+			}
+		}
+
+	public:
+
+		//*********************************************** SERIALIZE *********************************************\\
+
+		/**
+		* Serializes the contents of the curent JSON structure.
+		* Will be a "flat packed" JSON object with no newline formatting.
+		* @param t_node_object A nested JSON object within the JSON structure.
+		* @returns std::string
+		*/
+		static std::string serialize(const Node& t_node_object)
+		{
+			const Node* temp_root = &t_node_object;
+			while (temp_root->m_parent != nullptr)
+			{
+				temp_root = temp_root->m_parent;
+			}
+			std::string output;
+			write_node(t_node_object, output, temp_root->m_cache_serialized);
+			return output;
+		}
+
+		static std::string serialize(const JSON& t_main_list)
+		{
+			return serialize(t_main_list.main_list);
+		}
+
+	private:
+		/*
+		* Appends the text of an object to t_output. Makes recursive calls when encountering another object.
+		* When t_use_cache is set, objects whose cached text is still valid are copied verbatim and the text of every
+		* other object is stored for the next call.
+		*/
+		static void write_node(const Node& t_node_object, std::string& t_output, const bool t_use_cache)
+		{
+			if (t_use_cache && t_node_object.m_serialized_valid)
+			{
+				t_output += t_node_object.m_serialized;
+				return;
+			}
+			const std::vector<Node::JSON_KVP>* main_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&t_node_object.m_kvp);
+			if (main_vector_ptr == nullptr)
+			{
+				t_output += "NULL";
+				return;
+			}
+			size_t begin = t_output.size();
+			t_output += '{';
+			bool first_pair = true;
+			for (const Node::JSON_KVP& kvp : *main_vector_ptr)
+			{
+				if (kvp.m_removed)
+				{
+					continue;
+				}
+				if (!first_pair)
+				{
+					t_output += ", ";
+				}
+				first_pair = false;
+				t_output += kvp.m_key;
+				t_output += " : ";
+
+				const Node::JSON_Value* temp_value_ptr = &kvp.m_value;
+				if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&temp_value_ptr->m_value_individual))
+				{
+					t_output += convert_to_text(*temp_array, t_use_cache);
+				}
+				else
+				{
+					if (const std::shared_ptr<Node>* temp_value_individual_ptr = std::get_if<std::shared_ptr<Node>>(&temp_value_ptr->m_value_individual)) // is an object
+					{
+						write_node(**temp_value_individual_ptr, t_output, t_use_cache);
+					}
+					// is a primitive value, determine type and convert to string
+					else if (std::holds_alternative<int>(temp_value_ptr->m_value_individual))
+					{
+						t_output += std::to_string(std::get<int>(temp_value_ptr->m_value_individual));
+					}
+					else if (std::holds_alternative<double>(temp_value_ptr->m_value_individual))
+					{
+						t_output += std::to_string(std::get<double>(temp_value_ptr->m_value_individual));
+					}
+					else if (const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&temp_value_ptr->m_value_individual))
+					{
+						t_output += temp_number->m_text;
+					}
+					else if (std::holds_alternative<bool>(temp_value_ptr->m_value_individual))
+					{
+						t_output += std::to_string(std::get<bool>(temp_value_ptr->m_value_individual));
+					}
+					else if (std::holds_alternative<std::string>(temp_value_ptr->m_value_individual))
+					{
+						t_output += std::get<std::string>(temp_value_ptr->m_value_individual);
+					}
+					else if (std::holds_alternative<std::nullptr_t>(temp_value_ptr->m_value_individual))
+					{
+						t_output += "null";
+					}
+				}
+			}
+			t_output += '}';
+			if (t_use_cache)
+			{
+				t_node_object.m_serialized.assign(t_output, begin, std::string::npos);
+				t_node_object.m_serialized_valid = true;
+			}
+		}
+
+		//************************************************ MEMORY ***********************************************\\
+
+	public:
+		/*
+		* Byte counts reported by memory_usage(). Every heap block is attributed to exactly one category so the
+		* categories can be summed. Sizes of std::string and std::vector buffers are taken from their capacity, and
+		* short strings that fit in the small string buffer are counted as part of the object that holds them.
+		*/
+		struct Memory_Usage
+		{
+			size_t nodes = 0;		// Node objects, their shared_ptr control blocks, and their JSON_KVP vectors
+			size_t keys = 0;		// heap buffers of key strings
+			size_t strings = 0;		// heap buffers of string values
+			size_t arrays = 0;		// JSON_Value buffers of arrays
+			size_t cache = 0;		// heap buffers of text kept by the serialize cache
+			size_t pooled = 0;		// emptied nodes, containers, and strings kept by clear() for reuse
+			size_t index = 0;		// tables and entries of the key index
+			size_t overhead = 0;	// estimated allocator bookkeeping for every heap block counted above
+
+			size_t node_count = 0;
+			size_t kvp_count = 0;
+			size_t value_count = 0;
+			size_t allocation_count = 0;
+
+			size_t total() const noexcept
+			{
+				return nodes + keys + strings + arrays + cache + pooled + index + overhead;
+			}
+		};
+
+		/*
+		* Walks the JSON structure and estimates the number of bytes it occupies, including the JSON object itself,
+		* the storage kept by clear(), and the key index.
+		* @returns Memory_Usage
+		*/
+		Memory_Usage memory_usage() const
+		{
+			Memory_Usage usage;
+			std::unordered_set<const void*> visited;
+			usage.nodes += sizeof(JSON);
+			measure_node(main_list, usage, visited);
+			if (m_storage != nullptr)
+			{
+				measure_pool(*m_storage, usage);
+			}
+			if (m_key_index != nullptr)
+			{
+				measure_key_index(*m_key_index, usage);
+			}
+			return usage;
+		}
+
+	private:
+		// malloc keeps a header in front of every block and rounds the block up to its alignment
+		static constexpr size_t k_allocation_header = sizeof(void*) * 2;
+		// a shared_ptr created from a raw pointer allocates a control block holding a vtable and two counters
+		static constexpr size_t k_control_block_size = sizeof(void*) * 2 + sizeof(long) * 2;
+
+		static void count_allocation(Memory_Usage& t_usage)
+		{
+			t_usage.allocation_count++;
+			t_usage.overhead += k_allocation_header;
+		}
+
+		// Returns the heap bytes used by a string, or 0 if the string is stored in its small string buffer.
+		static size_t string_heap_size(const std::string& t_string)
+		{
+			const char* object_begin = reinterpret_cast<const char*>(&t_string);
+			const char* object_end = object_begin + sizeof(std::string);
+			if (t_string.data() >= object_begin && t_string.data() < object_end)
+			{
+				return 0;
+			}
+			return t_string.capacity() + 1;
+		}
+
+		static void measure_string(const std::string& t_string, size_t& t_category, Memory_Usage& t_usage)
+		{
+			size_t heap_size = string_heap_size(t_string);
+			if (heap_size > 0)
+			{
+				t_category += heap_size;
+				count_allocation(t_usage);
+			}
+		}
+
+		static void measure_array(const std::vector<Node::JSON_Value>& t_array, Memory_Usage& t_usage, std::unordered_set<const void*>& t_visited)
+		{
+			if (t_array.capacity() > 0)
+			{
+				t_usage.arrays += t_array.capacity() * sizeof(Node::JSON_Value);
+				count_allocation(t_usage);
+			}
+			for (const Node::JSON_Value& element : t_array)
+			{
+				measure_value(element, t_usage, t_visited);
+			}
+		}
+
+		// Measures the heap memory owned by a value. The value itself is counted by the container that holds it.
+		static void measure_value(const Node::JSON_Value& t_value, Memory_Usage& t_usage, std::unordered_set<const void*>& t_visited)
+		{
+			t_usage.value_count++;
+			if (const std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual))
+			{
+				measure_string(*temp_string, t_usage.strings, t_usage);
+			}
+			else if (const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual))
+			{
+				measure_string(temp_number->m_text, t_usage.strings, t_usage);
+			}
+			else if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				if (*temp_node != nullptr && t_visited.insert(temp_node->get()).second)
+				{
+					t_usage.nodes += sizeof(Node) + k_control_block_size;
+					count_allocation(t_usage);
+					count_allocation(t_usage);
+					measure_node(**temp_node, t_usage, t_visited);
+				}
+			}
+			else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				measure_array(*temp_array, t_usage, t_visited);
+			}
+		}
+
+		static void measure_kvp(const Node::JSON_KVP& t_kvp, Memory_Usage& t_usage, std::unordered_set<const void*>& t_visited)
+		{
+			t_usage.kvp_count++;
+			measure_string(t_kvp.m_key, t_usage.keys, t_usage);
+			measure_value(t_kvp.m_value, t_usage, t_visited);
+		}
+
+		// Measures the heap memory owned by a node. The Node object itself is counted by its owner.
+		static void measure_node(const Node& t_node, Memory_Usage& t_usage, std::unordered_set<const void*>& t_visited)
+		{
+			t_usage.node_count++;
+			measure_string(t_node.m_object_key, t_usage.keys, t_usage);
+			measure_string(t_node.m_serialized, t_usage.cache, t_usage);
+			if (const Node::JSON_KVP* temp_kvp = std::get_if<Node::JSON_KVP>(&t_node.m_kvp))
+			{
+				measure_kvp(*temp_kvp, t_usage, t_visited);
+			}
+			else if (const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp))
+			{
+				if (temp_kvp_array->capacity() > 0)
+				{
+					t_usage.nodes += temp_kvp_array->capacity() * sizeof(Node::JSON_KVP);
+					count_allocation(t_usage);
+				}
+				for (const Node::JSON_KVP& kvp : *temp_kvp_array)
+				{
+					measure_kvp(kvp, t_usage, t_visited);
+				}
+			}
+		}
+
+		// Adds a buffer of t_size bytes to t_category, if the buffer has been allocated.
+		static void measure_buffer(const size_t t_size, size_t& t_category, Memory_Usage& t_usage)
+		{
+			if (t_size > 0)
+			{
+				t_category += t_size;
+				count_allocation(t_usage);
+			}
+		}
+
+		/*
+		* Hash tables are estimated from their layout in the common standard libraries: a bucket array of pointers
+		* and one heap node per entry holding a next pointer, the cached hash, and the entry.
+		*/
+		static void measure_key_index(const Key_Index& t_index, Memory_Usage& t_usage)
+		{
+			measure_buffer(sizeof(Key_Index), t_usage.index, t_usage);
+			measure_buffer(t_index.m_locations.bucket_count() * sizeof(void*), t_usage.index, t_usage);
+			for (const auto& entry : t_index.m_locations)
+			{
+				measure_buffer(sizeof(void*) + sizeof(size_t) + sizeof(entry), t_usage.index, t_usage);
+				measure_string(entry.first, t_usage.index, t_usage);
+				measure_buffer(entry.second.capacity() * sizeof(Key_Index::Location), t_usage.index, t_usage);
+			}
+			measure_buffer(t_index.m_unordered.bucket_count() * sizeof(void*), t_usage.index, t_usage);
+			for (const std::string& key : t_index.m_unordered)
+			{
+				measure_buffer(sizeof(void*) + sizeof(size_t) + sizeof(key), t_usage.index, t_usage);
+				measure_string(key, t_usage.index, t_usage);
+			}
+		}
+
+		// Recycled containers are empty, so only their buffers and the strings they kept are counted.
+		static void measure_pool(const Storage_Pool& t_pool, Memory_Usage& t_usage)
+		{
+			measure_buffer(sizeof(Storage_Pool), t_usage.pooled, t_usage);
+			measure_buffer(t_pool.m_nodes.capacity() * sizeof(std::shared_ptr<Node>), t_usage.pooled, t_usage);
+			measure_buffer(t_pool.m_members.capacity() * sizeof(std::vector<Node::JSON_KVP>), t_usage.pooled, t_usage);
+			measure_buffer(t_pool.m_elements.capacity() * sizeof(std::vector<Node::JSON_Value>), t_usage.pooled, t_usage);
+			measure_buffer(t_pool.m_strings.capacity() * sizeof(std::string), t_usage.pooled, t_usage);
+			for (const std::shared_ptr<Node>& node : t_pool.m_nodes)
+			{
+				t_usage.pooled += sizeof(Node) + k_control_block_size;
+				count_allocation(t_usage);
+				count_allocation(t_usage);
+				measure_string(node->m_object_key, t_usage.pooled, t_usage);
+				measure_string(node->m_serialized, t_usage.pooled, t_usage);
+			}
+			for (const std::vector<Node::JSON_KVP>& members : t_pool.m_members)
+			{
+				measure_buffer(members.capacity() * sizeof(Node::JSON_KVP), t_usage.pooled, t_usage);
+			}
+			for (const std::vector<Node::JSON_Value>& elements : t_pool.m_elements)
+			{
+				measure_buffer(elements.capacity() * sizeof(Node::JSON_Value), t_usage.pooled, t_usage);
+			}
+			for (const std::string& string : t_pool.m_strings)
+			{
+				measure_string(string, t_usage.pooled, t_usage);
+			}
+		}
+
+		//************************************************ BINDING **********************************************\\
+
+	public:
+		/*
+		* Parses JSON text directly into a struct bound with JSONATOR_BIND(). No JSON structure is built; values are
+		* converted straight from the text into the struct's members. Keys without a matching field are skipped and
+		* fields without a matching key keep their current value.
+		* @param t_json_input JSON formatted text input.
+		* @param t_output Struct to be filled.
+		* @returns false if the input contains a syntax error or a value that does not fit its field's type.
+		*/
+		template<typename T>
+		static bool parse_into(const std::string& t_json_input, T& t_output)
+		{
+			static_assert(is_json_bound<T>::value, "parse_into() requires a type bound with JSONATOR_BIND()");
+			Scanner scanner(t_json_input.data(), t_json_input.data() + t_json_input.size());
+			if (!read_bound_value(scanner, t_output))
+			{
+				return false;
+			}
+			scanner.skip_whitespace();
+			return scanner.at_end() ? true : scanner.fail();
+		}
+
+		/*
+		* Parses JSON text directly into a struct bound with JSONATOR_BIND().
+		* @param t_json_input JSON formatted text input.
+		* @returns The filled struct, or a default constructed struct if the input could not be parsed.
+		*/
+		template<typename T>
+		static T parse_into(const std::string& t_json_input)
+		{
+			T output{};
+			if (!parse_into(t_json_input, output))
+			{
+				return T{};
+			}
+			return output;
+		}
+
+		/*
+		* Serializes a struct bound with JSONATOR_BIND() without building a JSON structure.
+		* Unlike serialize(const JSON&) the output is standard JSON with quoted keys and escaped strings so it can be
+		* read back with parse_into().
+		* @returns std::string
+		*/
+		template<typename T, typename std::enable_if<is_json_bound<T>::value, int>::type = 0>
+		static std::string serialize(const T& t_object)
+		{
+			std::string output;
+			write_bound_value(output, t_object);
+			return output;
+		}
+
+	private:
+		template<typename T>
+		struct dependent_false : std::false_type {};
+
+		// Converts the next value in the scanner into t_output using the converter for T.
+		template<typename T>
+		static bool read_bound_value(Scanner& t_scanner, T& t_output)
+		{
+			t_scanner.skip_whitespace();
+			if constexpr (is_json_bound<T>::value)
+			{
+				return read_bound_object(t_scanner, t_output);
+			}
+			else if constexpr (std::is_same<T, bool>::value)
+			{
+				if (t_scanner.consume_literal("true"))
+				{
+					t_output = true;
+					return true;
+				}
+				if (t_scanner.consume_literal("false"))
+				{
+					t_output = false;
+					return true;
+				}
+				return t_scanner.fail();
+			}
+			else if constexpr (std::is_arithmetic<T>::value)
+			{
+				const char* number_begin = nullptr;
+				const char* number_end = nullptr;
+				if (!t_scanner.read_number(number_begin, number_end))
+				{
+					return false;
+				}
+				std::from_chars_result result = std::from_chars(number_begin, number_end, t_output);
+				if (result.ec != std::errc() || result.ptr != number_end)
+				{
+					t_scanner.m_current = number_begin;
+					return t_scanner.fail();
+				}
+				return true;
+			}
+			else if constexpr (std::is_same<T, std::string>::value)
+			{
+				return t_scanner.read_string(t_output);
+			}
+			else if constexpr (is_json_optional<T>::value)
+			{
+				if (t_scanner.consume_literal("null"))
+				{
+					t_output.reset();
+					return true;
+				}
+				if (!t_output.has_value())
+				{
+					t_output.emplace();
+				}
+				return read_bound_value(t_scanner, *t_output);
+			}
+			else if constexpr (is_json_vector<T>::value)
+			{
+				t_output.clear();
+				if (!t_scanner.consume('['))
+				{
+					return t_scanner.fail();
+				}
+				t_scanner.skip_whitespace();
+				if (t_scanner.consume(']'))
+				{
+					return true;
+				}
+				while (true)
+				{
+					typename T::value_type element{};
+					if (!read_bound_value(t_scanner, element))
+					{
+						return false;
+					}
+					t_output.push_back(std::move(element));
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume(']'))
+					{
+						return true;
+					}
+					if (!t_scanner.consume(','))
+					{
+						return t_scanner.fail();
+					}
+				}
+			}
+			else
+			{
+				static_assert(dependent_false<T>::value, "member type is not supported by JSONATOR_BIND()");
+				return false;
+			}
+		}
+
+		template<typename T>
+		static bool read_bound_object(Scanner& t_scanner, T& t_output)
+		{
+			if (!t_scanner.consume('{'))
+			{
+				return t_scanner.fail();
+			}
+			t_scanner.skip_whitespace();
+			if (t_scanner.consume('}'))
+			{
+				return true;
+			}
+			std::string key;
+			while (true)
+			{
+				t_scanner.skip_whitespace();
+				if (!t_scanner.read_key(key))
+				{
+					return false;
+				}
+				t_scanner.skip_whitespace();
+				if (!t_scanner.consume(':'))
+				{
+					return t_scanner.fail();
+				}
+
+				bool matched = false;
+				bool success = true;
+				std::apply([&](const auto&... t_fields)
+				{
+					// stops at the first field whose name matches the key
+					(void)((matched = read_bound_field(t_scanner, t_output, t_fields, key, success)) || ...);
+				}, JSON_Binding<T>::fields());
+				if (!success)
+				{
+					return false;
+				}
+				if (!matched && !t_scanner.skip_value())
+				{
+					return false;
+				}
+
+				t_scanner.skip_whitespace();
+				if (t_scanner.consume('}'))
+				{
+					return true;
+				}
+				if (!t_scanner.consume(','))
+				{
+					return t_scanner.fail();
+				}
+			}
+		}
+
+		// Reads the value into the field if the field's name matches t_key. Returns true if the key matched.
+		template<typename T, typename Member>
+		static bool read_bound_field(Scanner& t_scanner, T& t_output, const JSON_Field<T, Member>& t_field, const std::string& t_key, bool& t_success)
+		{
+			if (t_key.size() != t_field.m_name_length || std::memcmp(t_key.data(), t_field.m_name, t_field.m_name_length) != 0)
+			{
+				return false;
+			}
+			t_success = read_bound_value(t_scanner, t_output.*(t_field.m_member));
+			return true;
+		}
+
+		// Appends a string to t_output as a quoted JSON string, escaping quotes, backslashes, and control characters.
+		static void write_escaped_string(std::string& t_output, const std::string& t_input)
+		{
+			static const char hex_digits[] = "0123456789abcdef";
+			t_output.push_back('"');
+			for (char current : t_input)
+			{
+				switch (current)
+				{
+				case '"': t_output += "\\\""; break;
+				case '\\': t_output += "\\\\"; break;
+				case '\b': t_output += "\\b"; break;
+				case '\f': t_output += "\\f"; break;
+				case '\n': t_output += "\\n"; break;
+				case '\r': t_output += "\\r"; break;
+				case '\t': t_output += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(current) < 0x20)
+					{
+						t_output += "\\u00";
+						t_output.push_back(hex_digits[(current >> 4) & 0xF]);
+						t_output.push_back(hex_digits[current & 0xF]);
+					}
+					else
+					{
+						t_output.push_back(current);
+					}
+				}
+			}
+			t_output.push_back('"');
+		}
+
+		template<typename T>
+		static void write_bound_value(std::string& t_output, const T& t_value)
+		{
+			if constexpr (is_json_bound<T>::value)
+			{
+				t_output.push_back('{');
+				bool first = true;
+				std::apply([&](const auto&... t_fields)
+				{
+					((write_bound_field(t_output, t_value, t_fields, first)), ...);
+				}, JSON_Binding<T>::fields());
+				t_output.push_back('}');
+			}
+			else if constexpr (std::is_same<T, bool>::value)
+			{
+				t_output += t_value ? "true" : "false";
+			}
+			else if constexpr (std::is_arithmetic<T>::value)
+			{
+				char buffer[32];
+				std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), t_value);
+				t_output.append(buffer, result.ptr);
+			}
+			else if constexpr (std::is_same<T, std::string>::value)
+			{
+				write_escaped_string(t_output, t_value);
+			}
+			else if constexpr (is_json_optional<T>::value)
+			{
+				if (t_value.has_value())
+				{
+					write_bound_value(t_output, *t_value);
+				}
+				else
+				{
+					t_output += "null";
+				}
+			}
+			else if constexpr (is_json_vector<T>::value)
+			{
+				t_output.push_back('[');
+				for (size_t i = 0; i < t_value.size(); i++)
+				{
+					if (i > 0)
+					{
+						t_output += ", ";
+					}
+					write_bound_value(t_output, t_value[i]);
+				}
+				t_output.push_back(']');
+			}
+			else
+			{
+				static_assert(dependent_false<T>::value, "member type is not supported by JSONATOR_BIND()");
+			}
+		}
+
+		template<typename T, typename Member>
+		static void write_bound_field(std::string& t_output, const T& t_object, const JSON_Field<T, Member>& t_field, bool& t_first)
+		{
+			if (!t_first)
+			{
+				t_output += ", ";
+			}
+			t_first = false;
+			t_output.push_back('"');
+			t_output.append(t_field.m_name, t_field.m_name_length);
+			t_output += "\" : ";
+			write_bound_value(t_output, t_object.*(t_field.m_member));
+		}
+
+		//************************************************ EXTRACT **********************************************\\
+
+	public:
+		/*
+		* A value found by Path_Extractor. Numbers without a fraction or exponent are stored as 64 bit integers.
+		* Objects and arrays are stored as their original JSON text.
+		*/
+		struct Extracted_Value
+		{
+			enum class Type { MISSING, NULL_VALUE, INTEGER, DOUBLE, BOOL, STRING, OBJECT, ARRAY };
+
+			Type m_type = Type::MISSING;
+			long long m_int = 0;
+			double m_double = 0;
+			bool m_bool = false;
+			std::string m_string;
+
+			bool found() const noexcept
+			{
+				return m_type != Type::MISSING;
+			}
+
+			// Returns the integer or -1 if the value is not an integer.
+			long long as_int() const noexcept
+			{
+				return m_type == Type::INTEGER ? m_int : -1;
+			}
+
+			// Returns the number or -1 if the value is not a number.
+			double as_double() const noexcept
+			{
+				if (m_type == Type::DOUBLE)
+				{
+					return m_double;
+				}
+				return m_type == Type::INTEGER ? static_cast<double>(m_int) : -1;
+			}
+
+			// Returns the bool or false if the value is not a bool.
+			bool as_bool() const noexcept
+			{
+				return m_type == Type::BOOL ? m_bool : false;
+			}
+
+			// Returns the unquoted string, the JSON text of an object or array, or an empty string otherwise.
+			const std::string& as_string() const noexcept
+			{
+				return m_string;
+			}
+		};
+
+		/*
+		* Extracts a fixed set of paths from JSON text in a single pass without building a JSON structure.
+		* Paths use dot notation for keys and brackets for array indices, for example "user.id" or "items[0].sku".
+		* The paths are compiled into a tree once when the extractor is created. While scanning, subtrees that no path
+		* leads into are skipped by bracket matching, and scanning stops as soon as every path has been found.
+		* A path with a malformed index is never found and makes valid() return false.
+		* The extractor can be reused for any number of inputs.
+		*/
+		class Path_Extractor
+		{
+		private:
+			struct Path_Step
+			{
+				std::string m_key;
+				int m_index = -1;				// array index, or -1 if this step is a key
+				std::vector<int> m_children;
+				int m_result = -1;				// index into m_results if a path ends at this step
+				size_t m_visited = 0;			// last pass that reached this step
+			};
+
+			std::vector<Path_Step> m_steps;		// m_steps[0] is the document root
+			std::vector<Extracted_Value> m_results;
+			std::vector<int> m_result_of_path;	// duplicate paths share one result, invalid paths have -1
+			Extracted_Value m_invalid_result;	// always MISSING, returned for invalid paths
+			size_t m_remaining = 0;
+			size_t m_pass = 0;
+			std::string m_key_buffer;
+
+		public:
+			Path_Extractor(const std::vector<std::string>& t_paths)
+			{
+				m_steps.emplace_back();
+				for (const std::string& path : t_paths)
+				{
+					m_result_of_path.push_back(add_path(path));
+				}
+			}
+
+			/*
+			* Scans JSON text and stores the values of the paths, replacing the results of any previous call.
+			* @param t_json_input JSON formatted text input.
+			* @returns false if a syntax error was found before all paths were found. Missing paths are not errors.
+			*/
+			bool extract(const std::string& t_json_input)
+			{
+				for (Extracted_Value& result : m_results)
+				{
+					result.m_type = Extracted_Value::Type::MISSING;
+				}
+				m_remaining = m_results.size();
+				m_pass++;
+				Scanner scanner(t_json_input.data(), t_json_input.data() + t_json_input.size());
+				if (!extract_value(scanner, 0))
+				{
+					return false;
+				}
+				if (m_remaining > 0)
+				{
+					scanner.skip_whitespace();
+					return scanner.at_end() ? true : scanner.fail();
+				}
+				return true;
+			}
+
+			// Returns the result for the path at t_index in the list given to the constructor.
+			const Extracted_Value& operator[](const size_t t_index) const
+			{
+				return m_result_of_path[t_index] < 0 ? m_invalid_result : m_results[m_result_of_path[t_index]];
+			}
+
+			size_t size() const noexcept
+			{
+				return m_result_of_path.size();
+			}
+
+			// Returns false if any valid path was not found, or if any path is invalid.
+			bool all_found() const noexcept
+			{
+				return m_remaining == 0 && valid();
+			}
+
+			// Returns false if a path could not be read. Invalid paths are never found.
+			bool valid() const noexcept
+			{
+				return std::find(m_result_of_path.begin(), m_result_of_path.end(), -1) == m_result_of_path.end();
+			}
+
+		private:
+			int find_or_add_child(const int t_parent, const std::string& t_key, const int t_index)
+			{
+				for (int child : m_steps[t_parent].m_children)
+				{
+					if (m_steps[child].m_index == t_index && m_steps[child].m_key == t_key)
+					{
+						return child;
+					}
+				}
+				Path_Step step;
+				step.m_key = t_key;
+				step.m_index = t_index;
+				m_steps.push_back(step);
+				int child = static_cast<int>(m_steps.size() - 1);
+				m_steps[t_parent].m_children.push_back(child);
+				return child;
+			}
+
+			// Adds the steps of a path to the tree and returns the index of its result, or -1 if the path is invalid.
+			int add_path(const std::string& t_path)
+			{
+				std::vector<Dot_Path_Step> path_steps;
+				if (!read_dot_path(t_path, path_steps))
+				{
+					return -1;
+				}
+				int current = 0;
+				for (const Dot_Path_Step& path_step : path_steps)
+				{
+					current = find_or_add_child(current, path_step.m_key, path_step.m_index);
+				}
+				if (m_steps[current].m_result < 0)
+				{
+					m_steps[current].m_result = static_cast<int>(m_results.size());
+					m_results.emplace_back();
+				}
+				return m_steps[current].m_result;
+			}
+
+			int find_key_child(const Path_Step& t_step, const std::string& t_key) const
+			{
+				for (int child : t_step.m_children)
+				{
+					if (m_steps[child].m_index < 0 && m_steps[child].m_key == t_key)
+					{
+						return child;
+					}
+				}
+				return -1;
+			}
+
+			int find_index_child(const Path_Step& t_step, const int t_index) const
+			{
+				for (int child : t_step.m_children)
+				{
+					if (m_steps[child].m_index == t_index)
+					{
+						return child;
+					}
+				}
+				return -1;
+			}
+
+			// Reads a scalar into t_result. Containers are handled by extract_value().
+			static bool read_scalar(Scanner& t_scanner, Extracted_Value& t_result)
+			{
+				char first = t_scanner.peek();
+				if (first == '"' || first == '\'')
+				{
+					t_result.m_type = Extracted_Value::Type::STRING;
+					return t_scanner.read_string(t_result.m_string);
+				}
+				if (t_scanner.consume_literal("true") || t_scanner.consume_literal("false"))
+				{
+					t_result.m_type = Extracted_Value::Type::BOOL;
+					t_result.m_bool = first == 't';
+					return true;
+				}
+				if (t_scanner.consume_literal("null"))
+				{
+					t_result.m_type = Extracted_Value::Type::NULL_VALUE;
+					return true;
+				}
+				const char* number_begin = nullptr;
+				const char* number_end = nullptr;
+				if (!t_scanner.read_number(number_begin, number_end))
+				{
+					return false;
+				}
+				if (!Scanner::is_floating_point(number_begin, number_end))
+				{
+					std::from_chars_result result = std::from_chars(number_begin, number_end, t_result.m_int);
+					if (result.ec == std::errc() && result.ptr == number_end)
+					{
+						t_result.m_type = Extracted_Value::Type::INTEGER;
+						return true;
+					}
+				}
+				std::from_chars_result result = std::from_chars(number_begin, number_end, t_result.m_double);
+				if (result.ec != std::errc() || result.ptr != number_end)
+				{
+					t_scanner.m_current = number_begin;
+					return t_scanner.fail();
+				}
+				t_result.m_type = Extracted_Value::Type::DOUBLE;
+				return true;
+			}
+
+			/*
+			* Reads the value at the current position, which is reached by t_step. Children of the step are searched
+			* for inside objects and arrays, everything else is skipped. Every step leads to one place in the
+			* document, so a step reached again by a repeated key is skipped and the first value is kept, as in dn().
+			* @returns false on a syntax error.
+			*/
+			bool extract_value(Scanner& t_scanner, const int t_step)
+			{
+				t_scanner.skip_whitespace();
+				Path_Step& step = m_steps[t_step];
+				if (step.m_visited == m_pass)
+				{
+					return t_scanner.skip_value();
+				}
+				step.m_visited = m_pass;
+				const char* value_begin = t_scanner.m_current;
+				char first = t_scanner.peek();
+				bool is_container = first == '{' || first == '[';
+
+				if (step.m_children.empty() || !is_container)
+				{
+					if (step.m_result < 0)
+					{
+						return t_scanner.skip_value();
+					}
+					Extracted_Value& result = m_results[step.m_result];
+					if (is_container)
+					{
+						if (!t_scanner.skip_value())
+						{
+							return false;
+						}
+						result.m_type = first == '{' ? Extracted_Value::Type::OBJECT : Extracted_Value::Type::ARRAY;
+						result.m_string.assign(value_begin, t_scanner.m_current);
+					}
+					else if (!read_scalar(t_scanner, result))
+					{
+						return false;
+					}
+					m_remaining--;
+					return true;
+				}
+
+				// descend into the container looking for the children of this step
+				t_scanner.m_current++;
+				t_scanner.skip_whitespace();
+				int index = 0;
+				if (!t_scanner.consume(first == '{' ? '}' : ']'))
+				{
+					while (true)
+					{
+						int child = -1;
+						if (first == '{')
+						{
+							t_scanner.skip_whitespace();
+							if (!t_scanner.read_key(m_key_buffer))
+							{
+								return false;
+							}
+							t_scanner.skip_whitespace();
+							if (!t_scanner.consume(':'))
+							{
+								return t_scanner.fail();
+							}
+							child = find_key_child(step, m_key_buffer);
+						}
+						else
+						{
+							child = find_index_child(step, index++);
+						}
+
+						if (child < 0)
+						{
+							if (!t_scanner.skip_value())
+							{
+								return false;
+							}
+						}
+						else if (!extract_value(t_scanner, child))
+						{
+							return false;
+						}
+						if (m_remaining == 0)
+						{
+							return true;
+						}
+
+						t_scanner.skip_whitespace();
+						if (t_scanner.consume(first == '{' ? '}' : ']'))
+						{
+							break;
+						}
+						if (!t_scanner.consume(','))
+						{
+							return t_scanner.fail();
+						}
+					}
+				}
+
+				if (step.m_result >= 0)
+				{
+					Extracted_Value& result = m_results[step.m_result];
+					result.m_type = first == '{' ? Extracted_Value::Type::OBJECT : Extracted_Value::Type::ARRAY;
+					result.m_string.assign(value_begin, t_scanner.m_current);
+					m_remaining--;
+				}
+				return true;
+			}
+		};
+
+	private:
+		// Step of a path read by read_dot_path(), either a key or an array index.
+		struct Dot_Path_Step
+		{
+			std::string m_key;
+			int m_index = -1;	// array index, or -1 if this step is a key
+		};
+
+		/*
+		* Reads a path in dot notation with bracket indices, such as "items[0].sku", as used by Path_Extractor and
+		* Column_Extractor. A leading '$' is allowed as in JSONPath, and an empty path selects the root.
+		* @returns false if an index is not a non-negative integer or its bracket is not closed.
+		*/
+		static bool read_dot_path(const std::string& t_path, std::vector<Dot_Path_Step>& t_steps)
+		{
+			t_steps.clear();
+			size_t i = 0;
+			if (!t_path.empty() && t_path[0] == '$')
+			{
+				i++;
+			}
+			while (i < t_path.size())
+			{
+				if (t_path[i] == '.')
+				{
+					i++;
+				}
+				else if (t_path[i] == '[')
+				{
+					size_t close = t_path.find(']', i);
+					if (close == std::string::npos)
+					{
+						return false;
+					}
+					Dot_Path_Step step;
+					const char* index_begin = t_path.data() + i + 1;
+					const char* index_end = t_path.data() + close;
+					std::from_chars_result result = std::from_chars(index_begin, index_end, step.m_index);
+					if (index_begin == index_end || *index_begin == '-' || result.ec != std::errc() || result.ptr != index_end)
+					{
+						return false;
+					}
+					t_steps.push_back(std::move(step));
+					i = close + 1;
+				}
+				else
+				{
+					size_t end = t_path.find_first_of(".[", i);
+					if (end == std::string::npos)
+					{
+						end = t_path.size();
+					}
+					Dot_Path_Step step;
+					step.m_key = t_path.substr(i, end - i);
+					t_steps.push_back(std::move(step));
+					i = end;
+				}
+			}
+			return true;
+		}
+
+		//********************************************** PROJECTION *********************************************\\
+
+	public:
+		/*
+		* Set of key paths used to parse only part of a document. Paths use dot notation ("user.address.city").
+		* Arrays are transparent: a path continues into every element of an array it passes through.
+		* An allow list keeps only the listed paths, their subtrees, and the objects needed to reach them.
+		* A deny list keeps everything except the listed paths and their subtrees.
+		*/
+		class Projection
+		{
+			friend class JSON;
+		private:
+			struct Projection_Step
+			{
+				std::string m_key;
+				std::vector<int> m_children;
+				bool m_terminal = false;	// a listed path ends here
+			};
+
+			std::vector<Projection_Step> m_steps;	// m_steps[0] is the document root
+			bool m_allow = true;
+
+		public:
+			static Projection allow(const std::vector<std::string>& t_paths)
+			{
+				return Projection(t_paths, true);
+			}
+
+			static Projection deny(const std::vector<std::string>& t_paths)
+			{
+				return Projection(t_paths, false);
+			}
+
+		private:
+			Projection(const std::vector<std::string>& t_paths, const bool t_allow) : m_allow(t_allow)
+			{
+				m_steps.emplace_back();
+				for (const std::string& path : t_paths)
+				{
+					int current = 0;
+					size_t begin = 0;
+					while (begin <= path.size())
+					{
+						size_t end = path.find('.', begin);
+						if (end == std::string::npos)
+						{
+							end = path.size();
+						}
+						if (end > begin)
+						{
+							current = find_or_add_child(current, path.substr(begin, end - begin));
+						}
+						begin = end + 1;
+					}
+					m_steps[current].m_terminal = true;
+				}
+			}
+
+			int find_or_add_child(const int t_parent, const std::string& t_key)
+			{
+				int child = find_child(t_parent, t_key);
+				if (child >= 0)
+				{
+					return child;
+				}
+				Projection_Step step;
+				step.m_key = t_key;
+				m_steps.push_back(step);
+				child = static_cast<int>(m_steps.size() - 1);
+				m_steps[t_parent].m_children.push_back(child);
+				return child;
+			}
+
+			int find_child(const int t_parent, const std::string& t_key) const
+			{
+				for (int child : m_steps[t_parent].m_children)
+				{
+					if (m_steps[child].m_key == t_key)
+					{
+						return child;
+					}
+				}
+				return -1;
+			}
+		};
+
+		/**
+		* Parses only the parts of the input selected by a projection. Skipped values are passed over by bracket and
+		* quote matching without being converted, so time and memory scale with the data that is kept.
+		* @param t_json_input JSON formatted text input.
+		* @param t_projection Allow or deny list of key paths.
+		* @returns A JSON object holding the projected keys, or an empty JSON object on a syntax error.
+		*/
+		static JSON parse(const std::string& t_json_input, const Projection& t_projection)
+		{
+			JSON temp_list;
+			Projecting_Builder builder(temp_list.main_list, t_projection);
+			if (!parse_events(t_json_input, builder))
+			{
+				temp_list.main_list.m_kvp = std::monostate();
+			}
+			return temp_list;
+		}
+
+	private:
+		/*
+		* Document_Builder that asks the scanner to skip values outside of a projection.
+		* Keeps the projection step of every open container. A step of -1 means everything below is kept.
+		*/
+		class Projecting_Builder : public Document_Builder
+		{
+		private:
+			static constexpr int k_keep_all = -1;
+
+			const Projection& m_projection;
+			std::vector<int> m_step_stack;
+			std::vector<bool> m_is_array;
+			int m_next_step = 0;	// step of the value that follows the last key
+			bool m_skip = false;
+
+		public:
+			Projecting_Builder(Node& t_root, const Projection& t_projection) : Document_Builder(t_root), m_projection(t_projection) {}
+
+			bool start_object() { open(false); return Document_Builder::start_object(); }
+			bool start_array() { open(true); return Document_Builder::start_array(); }
+			bool end_object() { close(); return Document_Builder::end_object(); }
+			bool end_array() { close(); return Document_Builder::end_array(); }
+
+			bool key(const std::string& t_key)
+			{
+				int parent = m_step_stack.back();
+				m_skip = false;
+				if (parent == k_keep_all)
+				{
+					m_next_step = k_keep_all;
+					return Document_Builder::key(t_key);
+				}
+				int child = m_projection.find_child(parent, t_key);
+				if (m_projection.m_allow)
+				{
+					if (child < 0)
+					{
+						m_skip = true;
+					}
+					else
+					{
+						m_next_step = m_projection.m_steps[child].m_terminal ? k_keep_all : child;
+					}
+				}
+				else
+				{
+					if (child >= 0 && m_projection.m_steps[child].m_terminal)
+					{
+						m_skip = true;
+					}
+					else
+					{
+						m_next_step = child < 0 ? k_keep_all : child;
+					}
+				}
+				return Document_Builder::key(t_key);
+			}
+
+			bool skip_next_value()
+			{
+				return m_skip;
+			}
+
+		private:
+			// Containers inside arrays use the array's step, all others use the step of their key.
+			void open(const bool t_is_array)
+			{
+				int step = 0;
+				if (!m_step_stack.empty())
+				{
+					step = m_is_array.back() ? m_step_stack.back() : m_next_step;
+				}
+				m_step_stack.push_back(step);
+				m_is_array.push_back(t_is_array);
+			}
+
+			void close()
+			{
+				m_step_stack.pop_back();
+				m_is_array.pop_back();
+			}
+		};
+
+		//*********************************************** KEY INDEX *********************************************\\
+
+	private:
+		/*
+		* Inverted index from keys to the objects that contain them. Entries added by a full build are in document
+		* order, and keys that gained entries later are sorted back into document order when they are next looked up.
+		* Sorting compares the order number every pair carries. The numbers are assigned by one walk of the document
+		* the first time a sort needs them after pairs were added, so renaming keys never causes a walk.
+		* Objects are held by weak_ptr so removing a subtree needs no index update: its entries expire and are
+		* dropped the next time they are visited. Entries whose key was removed or renamed are dropped the same way.
+		* Each entry remembers the position of the key in its object so most lookups do not scan the object.
+		*/
+		class Key_Index
+		{
+		public:
+			struct Location
+			{
+				std::weak_ptr<Node> m_node;
+				bool m_is_root = false;	// the key is in the document root, which is not owned by a shared_ptr
+				size_t m_position = 0;
+			};
+
+			std::unordered_map<std::string, std::vector<Location>> m_locations;
+			std::unordered_set<std::string> m_unordered;	// keys with entries added after the index was built
+			bool m_renumber = true;	// pairs were added since the pairs were last numbered
+		};
+
+		// Points every pair and nested object directly inside t_node back to t_node.
+		static void link_children(Node& t_node)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				kvp.m_owner = &t_node;
+				link_value(kvp.m_value, &t_node);
+			}
+		}
+
+		static void link_value(Node::JSON_Value& t_value, Node* t_owner)
+		{
+			t_value.m_owner = t_owner;
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				(*temp_node)->m_parent = t_owner;
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					link_value(element, t_owner);
+				}
+			}
+		}
+
+		// The root node lives inside the JSON object, so its children must be relinked whenever the JSON moves.
+		void relink_root()
+		{
+			main_list.m_parent = nullptr;
+			main_list.m_key_index = m_key_index.get();
+			link_children(main_list);
+		}
+
+		static Node::JSON_Value clone_value(const Node::JSON_Value& t_value)
+		{
+			Node::JSON_Value temp_value;
+			if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				std::shared_ptr<Node> temp_node_object(new Node);
+				clone_node(**temp_node, *temp_node_object);
+				temp_value.m_value_individual = std::move(temp_node_object);
+			}
+			else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				std::vector<Node::JSON_Value> nested_array;
+				nested_array.reserve(temp_array->size());
+				for (const Node::JSON_Value& element : *temp_array)
+				{
+					if (!element.m_removed)
+					{
+						nested_array.push_back(clone_value(element));
+					}
+				}
+				temp_value.m_value_individual = std::move(nested_array);
+			}
+			else
+			{
+				temp_value.m_value_individual = t_value.m_value_individual;
+			}
+			return temp_value;
+		}
+
+		static Node::JSON_KVP clone_kvp(const Node::JSON_KVP& t_kvp)
+		{
+			Node::JSON_KVP temp_kvp;
+			temp_kvp.m_key = t_kvp.m_key;
+			temp_kvp.m_value = clone_value(t_kvp.m_value);
+			return temp_kvp;
+		}
+
+		// Deep copies the contents of t_source into t_destination and links the copied children.
+		static void clone_node(const Node& t_source, Node& t_destination)
+		{
+			t_destination.m_object_key = t_source.m_object_key;
+			t_destination.m_serialized_valid = false;
+			t_destination.m_serialized.clear();
+			t_destination.m_hash = t_source.m_hash; // the copy has the same content
+			if (const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_source.m_kvp))
+			{
+				std::vector<Node::JSON_KVP> temp_members;
+				temp_members.reserve(temp_kvp_array->size());
+				for (const Node::JSON_KVP& kvp : *temp_kvp_array)
+				{
+					if (!kvp.m_removed)
+					{
+						temp_members.push_back(clone_kvp(kvp));
+					}
+				}
+				t_destination.m_kvp = std::move(temp_members);
+			}
+			else if (const Node::JSON_KVP* temp_kvp = std::get_if<Node::JSON_KVP>(&t_source.m_kvp))
+			{
+				t_destination.m_kvp = clone_kvp(*temp_kvp);
+			}
+			else
+			{
+				t_destination.m_kvp = std::monostate();
+			}
+			link_children(t_destination);
+		}
+
+		void copy_from(const JSON& t_other)
+		{
+			clone_node(t_other.main_list, main_list);
+			main_list.m_defer_removals = false;	// the copy holds no marked entries
+			main_list.m_cache_serialized = t_other.main_list.m_cache_serialized;
+			m_key_index.reset();
+			relink_root();
+			if (t_other.m_key_index != nullptr)
+			{
+				enable_key_index();
+			}
+		}
+
+		// Returns the node that holds the key index for the document containing t_node.
+		static Node* find_root(Node* t_node)
+		{
+			while (t_node != nullptr && t_node->m_parent != nullptr)
+			{
+				t_node = t_node->m_parent;
+			}
+			return t_node;
+		}
+
+		// Records that t_node holds t_key at t_position.
+		static void index_key(Key_Index& t_index, Node& t_node, const std::string& t_key, const size_t t_position)
+		{
+			Key_Index::Location location;
+			location.m_node = t_node.weak_from_this();
+			location.m_is_root = t_node.m_parent == nullptr;
+			location.m_position = t_position;
+			t_index.m_locations[t_key].push_back(std::move(location));
+			t_index.m_unordered.insert(t_key);
+		}
+
+		static void index_node(Key_Index& t_index, Node& t_node)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			t_index.m_renumber = true;
+			for (size_t i = 0; i < temp_kvp_array->size(); i++)
+			{
+				Node::JSON_KVP& kvp = (*temp_kvp_array)[i];
+				index_key(t_index, t_node, kvp.m_key, i);
+				index_value(t_index, kvp.m_value);
+			}
+		}
+
+		static void index_value(Key_Index& t_index, Node::JSON_Value& t_value)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				index_node(t_index, **temp_node);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					index_value(t_index, element);
+				}
+			}
+		}
+
+		// Returns the node of an index entry, or nullptr if the node has been destroyed.
+		Node* resolve_location(const Key_Index::Location& t_location)
+		{
+			if (t_location.m_is_root)
+			{
+				return &main_list;
+			}
+			// the node is kept alive by its parent, so the raw pointer stays valid after the lock is released
+			return t_location.m_node.lock().get();
+		}
+
+		// Returns the position of t_key in t_node, updating the remembered position, or -1 if it is not there.
+		static int locate_key(Node& t_node, Key_Index::Location& t_location, const std::string& t_key)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return -1;
+			}
+			if (t_location.m_position < temp_kvp_array->size() && !(*temp_kvp_array)[t_location.m_position].m_removed
+				&& (*temp_kvp_array)[t_location.m_position].m_key == t_key)
+			{
+				return static_cast<int>(t_location.m_position);
+			}
+			for (size_t i = 0; i < temp_kvp_array->size(); i++)
+			{
+				if (!(*temp_kvp_array)[i].m_removed && (*temp_kvp_array)[i].m_key == t_key)
+				{
+					t_location.m_position = i;
+					return static_cast<int>(i);
+				}
+			}
+			return -1;
+		}
+
+		/*
+		* Drops expired, stale, and duplicate entries for t_key and returns the objects that still hold the key in
+		* index order, paired with the key's position in each.
+		*/
+		std::vector<std::pair<Node*, int>> collect_indexed(const std::string& t_key)
+		{
+			std::vector<std::pair<Node*, int>> found;
+			auto entry = m_key_index->m_locations.find(t_key);
+			if (entry == m_key_index->m_locations.end())
+			{
+				return found;
+			}
+			std::vector<Key_Index::Location>& locations = entry->second;
+			std::unordered_set<Node*> seen;
+			size_t kept = 0;
+			for (size_t i = 0; i < locations.size(); i++)
+			{
+				Node* temp_node = resolve_location(locations[i]);
+				if (temp_node == nullptr || !seen.insert(temp_node).second)
+				{
+					continue;
+				}
+				int position = locate_key(*temp_node, locations[i], t_key);
+				if (position < 0)
+				{
+					continue;
+				}
+				found.emplace_back(temp_node, position);
+				if (kept != i)
+				{
+					locations[kept] = std::move(locations[i]);
+				}
+				kept++;
+			}
+			locations.resize(kept);
+			if (kept == 0)
+			{
+				m_key_index->m_locations.erase(entry);
+			}
+			else if (m_key_index->m_unordered.erase(t_key) > 0)
+			{
+				sort_indexed(found, locations);
+			}
+			return found;
+		}
+
+		// Sorts the entries of one key into document order. t_found and t_locations hold the same entries.
+		void sort_indexed(std::vector<std::pair<Node*, int>>& t_found, std::vector<Key_Index::Location>& t_locations)
+		{
+			if (m_key_index->m_renumber)
+			{
+				size_t next_order = 0;
+				number_pairs(main_list, next_order);
+				m_key_index->m_renumber = false;
+			}
+			std::vector<size_t> order;
+			for (size_t i = 0; i < t_found.size(); i++)
+			{
+				order.push_back(i);
+			}
+			auto order_of = [&t_found](const size_t t_entry) { return std::get<std::vector<Node::JSON_KVP>>(t_found[t_entry].first->m_kvp)[t_found[t_entry].second].m_index_order; };
+			std::sort(order.begin(), order.end(), [&order_of](const size_t t_left, const size_t t_right) { return order_of(t_left) < order_of(t_right); });
+			std::vector<std::pair<Node*, int>> sorted_found;
+			std::vector<Key_Index::Location> sorted_locations;
+			for (size_t i : order)
+			{
+				sorted_found.push_back(t_found[i]);
+				sorted_locations.push_back(std::move(t_locations[i]));
+			}
+			t_found.swap(sorted_found);
+			t_locations.swap(sorted_locations);
+		}
+
+		// Numbers every pair in the order of a walk of the document that visits a pair before the objects in its value.
+		static void number_pairs(Node& t_node, size_t& t_next_order)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				kvp.m_index_order = t_next_order++;
+				number_value(kvp.m_value, t_next_order);
+			}
+		}
+
+		static void number_value(Node::JSON_Value& t_value, size_t& t_next_order)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				number_pairs(**temp_node, t_next_order);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					number_value(element, t_next_order);
+				}
+			}
+		}
+
+		void remove_first_indexed(const std::string& t_key)
+		{
+			std::vector<std::pair<Node*, int>> found = collect_indexed(t_key);
+			if (found.empty())
+			{
+				return;
+			}
+			std::vector<Node::JSON_KVP>& temp_kvp_array = std::get<std::vector<Node::JSON_KVP>>(found[0].first->m_kvp);
+			mark_dirty(found[0].first);
+			if (main_list.m_defer_removals)
+			{
+				temp_kvp_array[found[0].second].m_removed = true;
+			}
+			else
+			{
+				temp_kvp_array.erase(temp_kvp_array.begin() + found[0].second);
+			}
+		}
+
+		// Removes every pair with t_key from one object in a single pass.
+		static void remove_key_from_node(Node& t_node, const std::string& t_key, const bool t_defer)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				if (kvp.m_key == t_key)
+				{
+					kvp.m_removed = true;
+					mark_dirty(&t_node);
+				}
+			}
+			if (!t_defer)
+			{
+				erase_removed(*temp_kvp_array);
+			}
+		}
+
+		static void remove_all_recursive(Node& t_node, const std::string& t_key, const bool t_defer)
+		{
+			remove_key_from_node(t_node, t_key, t_defer);
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				if (kvp.m_removed)
+				{
+					continue;
+				}
+				remove_all_in_value(kvp.m_value, t_key, t_defer);
+			}
+		}
+
+		static void remove_all_in_value(Node::JSON_Value& t_value, const std::string& t_key, const bool t_defer)
+		{
+			if (t_value.m_removed)
+			{
+				return;
+			}
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				remove_all_recursive(**temp_node, t_key, t_defer);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					remove_all_in_value(element, t_key, t_defer);
+				}
+			}
+		}
+
+		static void find_all_recursive(Node& t_node, const std::string& t_key, std::vector<Node::JSON_KVP*>& t_found)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			bool found_in_node = false;
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				if (kvp.m_removed)
+				{
+					continue;
+				}
+				if (!found_in_node && kvp.m_key == t_key)
+				{
+					t_found.push_back(&kvp);
+					found_in_node = true;
+				}
+				find_all_in_value(kvp.m_value, t_key, t_found);
+			}
+		}
+
+		static void find_all_in_value(Node::JSON_Value& t_value, const std::string& t_key, std::vector<Node::JSON_KVP*>& t_found)
+		{
+			if (t_value.m_removed)
+			{
+				return;
+			}
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				find_all_recursive(**temp_node, t_key, t_found);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					find_all_in_value(element, t_key, t_found);
+				}
+			}
+		}
+
+	public:
+		/*
+		* Builds an index from every key to the objects that contain it. While the index is enabled find_all(),
+		* remove_first_found(), and remove_all() take time proportional to the number of matches instead of the
+		* size of the document. The index is kept up to date by the update and delete methods.
+		*/
+		void enable_key_index()
+		{
+			m_key_index.reset(new Key_Index);
+			main_list.m_key_index = m_key_index.get();
+			index_node(*m_key_index, main_list);
+			m_key_index->m_unordered.clear(); // a full build adds entries in document order
+		}
+
+		void disable_key_index() noexcept
+		{
+			m_key_index.reset();
+			main_list.m_key_index = nullptr;
+		}
+
+		bool has_key_index() const noexcept
+		{
+			return m_key_index != nullptr;
+		}
+
+		/*
+		* Finds every object in the JSON structure that contains t_key. Objects are reported once even if they
+		* contain the key more than once.
+		* @returns Pointers to the matching pairs, which can be passed to the return, update, and delete methods.
+		* Pointers are invalidated by any change to the object that holds the pair.
+		*/
+		std::vector<Node::JSON_KVP*> find_all(const std::string& t_key)
+		{
+			std::vector<Node::JSON_KVP*> found;
+			if (m_key_index == nullptr)
+			{
+				find_all_recursive(main_list, t_key, found);
+				return found;
+			}
+			for (const std::pair<Node*, int>& location : collect_indexed(t_key))
+			{
+				found.push_back(&std::get<std::vector<Node::JSON_KVP>>(location.first->m_kvp)[location.second]);
+			}
+			return found;
+		}
+
+		// Deletes every key-value pair in the JSON structure that has the given key.
+		void remove_all(const std::string& t_key)
+		{
+			if (m_key_index == nullptr)
+			{
+				remove_all_recursive(main_list, t_key, main_list.m_defer_removals);
+				return;
+			}
+			for (const std::pair<Node*, int>& location : collect_indexed(t_key))
+			{
+				remove_key_from_node(*location.first, t_key, main_list.m_defer_removals);
+			}
+			m_key_index->m_locations.erase(t_key);
+		}
+
+
+		//******************************************** SERIALIZE CACHE ******************************************\\
+
+	public:
+		/*
+		* Keeps the serialized text of every object so serialize() can copy unchanged objects verbatim. The update
+		* and delete methods invalidate the text of the changed object and of every object that contains it, so
+		* serializing after a small change costs time proportional to the changed objects instead of the document.
+		* The cache holds roughly one copy of the text per level of nesting. serialize() writes to the cache, so a
+		* JSON that uses it must not be serialized from several threads at once.
+		*/
+		void enable_serialize_cache() noexcept
+		{
+			main_list.m_cache_serialized = true;
+		}
+
+		// Stops caching and releases the cached text.
+		void disable_serialize_cache()
+		{
+			main_list.m_cache_serialized = false;
+			clear_serialized(main_list);
+		}
+
+		bool has_serialize_cache() const noexcept
+		{
+			return main_list.m_cache_serialized;
+		}
+
+	private:
+		// Invalidates the cached text and hash of t_node and of every object that contains it.
+		static void mark_dirty(Node* t_node) noexcept
+		{
+			while (t_node != nullptr)
+			{
+				t_node->m_serialized_valid = false;
+				t_node->m_hash.reset();
+				t_node = t_node->m_parent;
+			}
+		}
+
+		static void clear_serialized(Node& t_node)
+		{
+			t_node.m_serialized_valid = false;
+			std::string().swap(t_node.m_serialized);
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				clear_serialized_value(kvp.m_value);
+			}
+		}
+
+		static void clear_serialized_value(Node::JSON_Value& t_value)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				clear_serialized(**temp_node);
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					clear_serialized_value(element);
+				}
+			}
+		}
+
+
+		//************************************************* PATCH ***********************************************\\
+
+	public:
+		/*
+		* Applies an RFC 6902 JSON Patch in place. Supports the add, remove, replace, move, copy, and test operations.
+		* Paths are resolved by walking the JSON structure directly, so no error objects are allocated, and values
+		* are moved out of the patch instead of being copied. Deferred removals are compacted first so array
+		* indices in the patch count only entries that have not been removed.
+		* @param t_patch JSON array of operation objects. Pass it with std::move() to avoid copying it.
+		* @returns false if the patch is malformed or an operation fails. Operations before the failing one stay
+		* applied.
+		*/
+		bool apply_patch(JSON t_patch)
+		{
+			std::vector<Node::JSON_Value>* operations = root_array(t_patch.main_list);
+			if (operations == nullptr)
+			{
+				return false;
+			}
+			if (main_list.m_defer_removals)
+			{
+				compact_node(main_list);
+			}
+			for (Node::JSON_Value& operation : *operations)
+			{
+				std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&operation.m_value_individual);
+				if (temp_node == nullptr || !apply_operation(**temp_node))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Parses t_patch and applies it with apply_patch(JSON). Returns false on a syntax error.
+		bool apply_patch(const std::string& t_patch)
+		{
+			JSON temp_patch;
+			Document_Builder builder(temp_patch.main_list);
+			return parse_events(t_patch, builder) && apply_patch(std::move(temp_patch));
+		}
+
+		/*
+		* Applies an RFC 7386 JSON Merge Patch in place. Members of the patch replace the members of the same name,
+		* null members delete them, and nested objects are merged recursively. A patch that is not an object
+		* replaces the whole document. Values are moved out of the patch instead of being copied.
+		* @param t_patch JSON object to merge. Pass it with std::move() to avoid copying it.
+		* @returns false if the patch is empty.
+		*/
+		bool merge_patch(JSON t_patch)
+		{
+			std::vector<Node::JSON_KVP>* patch_members = std::get_if<std::vector<Node::JSON_KVP>>(&t_patch.main_list.m_kvp);
+			if (patch_members == nullptr)
+			{
+				return false;
+			}
+			if (!root_is_object(t_patch.main_list))
+			{
+				main_list.m_kvp = std::move(t_patch.main_list.m_kvp);
+				adopt_document();
+				return true;
+			}
+			if (!std::holds_alternative<std::vector<Node::JSON_KVP>>(main_list.m_kvp) || !root_is_object(main_list))
+			{
+				main_list.m_kvp = std::vector<Node::JSON_KVP>();
+				adopt_document();
+			}
+			merge_object(main_list, *patch_members);
+			return true;
+		}
+
+		// Parses t_patch and applies it with merge_patch(JSON). Returns false on a syntax error.
+		bool merge_patch(const std::string& t_patch)
+		{
+			JSON temp_patch;
+			Document_Builder builder(temp_patch.main_list);
+			return parse_events(t_patch, builder) && merge_patch(std::move(temp_patch));
+		}
+
+	private:
+
+		// The object or array that holds the value a path points to.
+		struct Patch_Location
+		{
+			Node* m_object = nullptr;							// set if the parent is an object
+			std::vector<Node::JSON_Value>* m_array = nullptr;	// set if the parent is an array
+			Node* m_owner = nullptr;							// object that holds the parent
+		};
+
+		// Read-only view of a value. Exactly one member is set.
+		struct Value_Ref
+		{
+			const Node* m_object = nullptr;
+			const std::vector<Node::JSON_Value>* m_elements = nullptr;
+			const Node::JSON_Value* m_scalar = nullptr;
+		};
+
+		bool apply_operation(Node& t_operation)
+		{
+			std::string op;
+			std::string path;
+			std::vector<std::string> tokens;
+			if (!read_member_string(t_operation, "op", op) || !read_member_string(t_operation, "path", path) || !read_pointer(path, tokens))
+			{
+				return false;
+			}
+			if (op == "add" || op == "replace" || op == "test")
+			{
+				Node::JSON_KVP* value = find_member(t_operation, "value");
+				if (value == nullptr)
+				{
+					return false;
+				}
+				if (op == "test")
+				{
+					Value_Ref target;
+					return find_value(tokens, target) && values_equal(target, make_ref(value->m_value));
+				}
+				return op == "add" ? patch_add(tokens, std::move(value->m_value)) : patch_replace(tokens, std::move(value->m_value));
+			}
+			if (op == "remove")
+			{
+				return patch_remove(tokens, nullptr);
+			}
+			if (op == "move" || op == "copy")
+			{
+				std::string from;
+				std::vector<std::string> from_tokens;
+				if (!read_member_string(t_operation, "from", from) || !read_pointer(from, from_tokens))
+				{
+					return false;
+				}
+				Value_Ref source;
+				if (!find_value(from_tokens, source))
+				{
+					return false;
+				}
+				if (op == "copy")
+				{
+					return patch_add(tokens, clone_ref(source));
+				}
+				if (from_tokens == tokens)
+				{
+					return true;
+				}
+				// a value cannot be moved into one of its own children
+				if (from_tokens.size() < tokens.size() && std::equal(from_tokens.begin(), from_tokens.end(), tokens.begin()))
+				{
+					return false;
+				}
+				Node::JSON_Value moved;
+				return patch_remove(from_tokens, &moved) && patch_add(tokens, std::move(moved));
+			}
+			return false;
+		}
+
+		// Splits an RFC 6901 JSON Pointer into unescaped tokens. The empty pointer refers to the whole document.
+		static bool read_pointer(const std::string& t_pointer, std::vector<std::string>& t_tokens)
+		{
+			t_tokens.clear();
+			if (t_pointer.empty())
+			{
+				return true;
+			}
+			if (t_pointer[0] != '/')
+			{
+				return false;
+			}
+			size_t begin = 1;
+			while (true)
+			{
+				size_t end = t_pointer.find('/', begin);
+				if (end == std::string::npos)
+				{
+					end = t_pointer.size();
+				}
+				std::string token;
+				for (size_t i = begin; i < end; i++)
+				{
+					if (t_pointer[i] != '~')
+					{
+						token += t_pointer[i];
+					}
+					else if (i + 1 < end && (t_pointer[i + 1] == '0' || t_pointer[i + 1] == '1'))
+					{
+						token += t_pointer[++i] == '0' ? '~' : '/';
+					}
+					else
+					{
+						return false;
+					}
+				}
+				t_tokens.push_back(std::move(token));
+				if (end == t_pointer.size())
+				{
+					return true;
+				}
+				begin = end + 1;
+			}
+		}
+
+		// Reads an array index token. "-" refers to the end of the array when t_allow_end is set.
+		static bool read_index(const std::string& t_token, const size_t t_size, const bool t_allow_end, size_t& t_index)
+		{
+			if (t_allow_end && t_token == "-")
+			{
+				t_index = t_size;
+				return true;
+			}
+			if (t_token.empty() || (t_token.size() > 1 && t_token[0] == '0'))
+			{
+				return false;
+			}
+			std::from_chars_result result = std::from_chars(t_token.data(), t_token.data() + t_token.size(), t_index);
+			if (result.ec != std::errc() || result.ptr != t_token.data() + t_token.size())
+			{
+				return false;
+			}
+			return t_index < t_size || (t_allow_end && t_index == t_size);
+		}
+
+		// Returns the elements of a document whose root is an array, which is stored under an empty key.
+		static const std::vector<Node::JSON_Value>* root_array(const Node& t_root)
+		{
+			const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_root.m_kvp);
+			if (temp_kvp_array == nullptr || temp_kvp_array->size() != 1 || !(*temp_kvp_array)[0].m_key.empty())
+			{
+				return nullptr;
+			}
+			return std::get_if<std::vector<Node::JSON_Value>>(&(*temp_kvp_array)[0].m_value.m_value_individual);
+		}
+
+		static std::vector<Node::JSON_Value>* root_array(Node& t_root)
+		{
+			return const_cast<std::vector<Node::JSON_Value>*>(root_array(static_cast<const Node&>(t_root)));
+		}
+
+		// Returns false if the root of the document is an array or a scalar, which are stored under an empty key.
+		static bool root_is_object(const Node& t_root)
+		{
+			const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_root.m_kvp);
+			return temp_kvp_array == nullptr || temp_kvp_array->size() != 1 || !(*temp_kvp_array)[0].m_key.empty()
+				|| std::holds_alternative<std::shared_ptr<Node>>((*temp_kvp_array)[0].m_value.m_value_individual);
+		}
+
+		// Returns the first pair in t_node with t_key that has not been removed, or nullptr.
+		static Node::JSON_KVP* find_member(Node& t_node, const std::string& t_key)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				return nullptr;
+			}
+			for (Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				if (!kvp.m_removed && kvp.m_key == t_key)
+				{
+					return &kvp;
+				}
+			}
+			return nullptr;
+		}
+
+		// Reads a string member of an operation object with its quotes removed and escape sequences decoded.
+		static bool read_member_string(Node& t_operation, const std::string& t_key, std::string& t_output)
+		{
+			Node::JSON_KVP* member = find_member(t_operation, t_key);
+			if (member == nullptr)
+			{
+				return false;
+			}
+			const std::string* temp_string = std::get_if<std::string>(&member->m_value.m_value_individual);
+			if (temp_string == nullptr)
+			{
+				return false;
+			}
+			Scanner scanner(temp_string->data(), temp_string->data() + temp_string->size());
+			return scanner.read_string(t_output);
+		}
+
+		bool root_location(Patch_Location& t_location)
+		{
+			if (std::holds_alternative<std::monostate>(main_list.m_kvp))
+			{
+				main_list.m_kvp = std::vector<Node::JSON_KVP>();
+			}
+			t_location.m_owner = &main_list;
+			t_location.m_array = root_array(main_list);
+			t_location.m_object = t_location.m_array == nullptr ? &main_list : nullptr;
+			return std::holds_alternative<std::vector<Node::JSON_KVP>>(main_list.m_kvp);
+		}
+
+		// Moves t_location to the object or array held by t_value.
+		static bool enter_value(Node::JSON_Value& t_value, Patch_Location& t_location)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				t_location.m_object = temp_node->get();
+				t_location.m_array = nullptr;
+				t_location.m_owner = temp_node->get();
+				return std::holds_alternative<std::vector<Node::JSON_KVP>>((*temp_node)->m_kvp);
+			}
+			if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				t_location.m_object = nullptr;
+				t_location.m_array = temp_array;
+				return true;
+			}
+			return false;
+		}
+
+		// Finds the object or array that holds the value at the end of a non-empty path.
+		bool resolve_parent(const std::vector<std::string>& t_tokens, Patch_Location& t_location)
+		{
+			if (!root_location(t_location))
+			{
+				return false;
+			}
+			for (size_t i = 0; i + 1 < t_tokens.size(); i++)
+			{
+				if (t_location.m_object != nullptr)
+				{
+					Node::JSON_KVP* member = find_member(*t_location.m_object, t_tokens[i]);
+					if (member == nullptr)
+					{
+						return false;
+					}
+					if (!enter_value(member->m_value, t_location))
+					{
+						return false;
+					}
+				}
+				else
+				{
+					size_t index = 0;
+					if (!read_index(t_tokens[i], t_location.m_array->size(), false, index) || !enter_value((*t_location.m_array)[index], t_location))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		static Value_Ref make_ref(const Node::JSON_Value& t_value)
+		{
+			Value_Ref temp_ref;
+			if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				temp_ref.m_object = temp_node->get();
+			}
+			else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				temp_ref.m_elements = temp_array;
+			}
+			else
+			{
+				temp_ref.m_scalar = &t_value;
+			}
+			return temp_ref;
+		}
+
+		bool find_value(const std::vector<std::string>& t_tokens, Value_Ref& t_value)
+		{
+			if (t_tokens.empty())
+			{
+				t_value = Value_Ref();
+				t_value.m_elements = root_array(main_list);
+				t_value.m_object = t_value.m_elements == nullptr ? &main_list : nullptr;
+				return true;
+			}
+			Patch_Location location;
+			if (!resolve_parent(t_tokens, location))
+			{
+				return false;
+			}
+			if (location.m_object != nullptr)
+			{
+				Node::JSON_KVP* member = find_member(*location.m_object, t_tokens.back());
+				if (member == nullptr)
+				{
+					return false;
+				}
+				t_value = make_ref(member->m_value);
+				return true;
+			}
+			size_t index = 0;
+			if (!read_index(t_tokens.back(), location.m_array->size(), false, index))
+			{
+				return false;
+			}
+			t_value = make_ref((*location.m_array)[index]);
+			return true;
+		}
+
+		static Node::JSON_Value clone_ref(const Value_Ref& t_value)
+		{
+			if (t_value.m_elements != nullptr)
+			{
+				std::vector<Node::JSON_Value> temp_elements;
+				temp_elements.reserve(t_value.m_elements->size());
+				for (const Node::JSON_Value& element : *t_value.m_elements)
+				{
+					if (!element.m_removed)
+					{
+						temp_elements.push_back(clone_value(element));
+					}
+				}
+				Node::JSON_Value temp_value;
+				temp_value.m_value_individual = std::move(temp_elements);
+				return temp_value;
+			}
+			if (t_value.m_object != nullptr)
+			{
+				std::shared_ptr<Node> temp_node_object(new Node);
+				clone_node(*t_value.m_object, *temp_node_object);
+				Node::JSON_Value temp_value;
+				temp_value.m_value_individual = std::move(temp_node_object);
+				return temp_value;
+			}
+			return clone_value(*t_value.m_scalar);
+		}
+
+		// Links the value of the pair at t_position to t_node, adds it to the key index, and marks t_node as changed.
+		void adopt_member(Node& t_node, const size_t t_position, const bool t_new_key)
+		{
+			Node::JSON_KVP& kvp = std::get<std::vector<Node::JSON_KVP>>(t_node.m_kvp)[t_position];
+			kvp.m_owner = &t_node;
+			if (m_key_index != nullptr && t_new_key)
+			{
+				index_key(*m_key_index, t_node, kvp.m_key, t_position);
+				m_key_index->m_renumber = true;
+			}
+			adopt_element(kvp.m_value, &t_node);
+			mark_dirty(&t_node);
+		}
+
+		void adopt_element(Node::JSON_Value& t_value, Node* t_owner)
+		{
+			link_value(t_value, t_owner);
+			if (m_key_index != nullptr)
+			{
+				index_value(*m_key_index, t_value);
+			}
+			mark_dirty(t_owner);
+		}
+
+		// Relinks and reindexes the document after its root has been replaced.
+		void adopt_document()
+		{
+			relink_root();
+			mark_dirty(&main_list);
+			if (m_key_index != nullptr)
+			{
+				enable_key_index();
+			}
+		}
+
+		bool replace_document(Node::JSON_Value&& t_value)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				main_list.m_kvp = std::move((*temp_node)->m_kvp);
+			}
+			else if (std::holds_alternative<std::vector<Node::JSON_Value>>(t_value.m_value_individual))
+			{
+				std::vector<Node::JSON_KVP> root_vector(1);
+				root_vector[0].m_value = std::move(t_value);
+				main_list.m_kvp = std::move(root_vector);
+			}
+			else
+			{
+				return false; // the root of a document must be an object or an array
+			}
+			adopt_document();
+			return true;
+		}
+
+		bool patch_add(const std::vector<std::string>& t_tokens, Node::JSON_Value&& t_value)
+		{
+			if (t_tokens.empty())
+			{
+				return replace_document(std::move(t_value));
+			}
+			Patch_Location location;
+			if (!resolve_parent(t_tokens, location))
+			{
+				return false;
+			}
+			if (location.m_object != nullptr)
+			{
+				std::vector<Node::JSON_KVP>& members = std::get<std::vector<Node::JSON_KVP>>(location.m_object->m_kvp);
+				Node::JSON_KVP* member = find_member(*location.m_object, t_tokens.back());
+				if (member != nullptr)
+				{
+					member->m_value = std::move(t_value);
+					adopt_member(*location.m_object, static_cast<size_t>(member - members.data()), false);
+					return true;
+				}
+				Node::JSON_KVP temp_kvp;
+				temp_kvp.m_key = t_tokens.back();
+				temp_kvp.m_value = std::move(t_value);
+				members.push_back(std::move(temp_kvp));
+				adopt_member(*location.m_object, members.size() - 1, true);
+				return true;
+			}
+			size_t index = 0;
+			if (!read_index(t_tokens.back(), location.m_array->size(), true, index))
+			{
+				return false;
+			}
+			std::vector<Node::JSON_Value>::iterator inserted = location.m_array->insert(location.m_array->begin() + index, std::move(t_value));
+			adopt_element(*inserted, location.m_owner);
+			return true;
+		}
+
+		bool patch_replace(const std::vector<std::string>& t_tokens, Node::JSON_Value&& t_value)
+		{
+			if (t_tokens.empty())
+			{
+				return replace_document(std::move(t_value));
+			}
+			Patch_Location location;
+			if (!resolve_parent(t_tokens, location))
+			{
+				return false;
+			}
+			if (location.m_object != nullptr)
+			{
+				Node::JSON_KVP* member = find_member(*location.m_object, t_tokens.back());
+				if (member == nullptr)
+				{
+					return false;
+				}
+				member->m_value = std::move(t_value);
+				adopt_member(*location.m_object, static_cast<size_t>(member - std::get<std::vector<Node::JSON_KVP>>(location.m_object->m_kvp).data()), false);
+				return true;
+			}
+			size_t index = 0;
+			if (!read_index(t_tokens.back(), location.m_array->size(), false, index))
+			{
+				return false;
+			}
+			(*location.m_array)[index] = std::move(t_value);
+			adopt_element((*location.m_array)[index], location.m_owner);
+			return true;
+		}
+
+		// Removes the value at a path. If t_removed is not null the value is moved into it.
+		bool patch_remove(const std::vector<std::string>& t_tokens, Node::JSON_Value* t_removed)
+		{
+			Patch_Location location;
+			if (t_tokens.empty() || !resolve_parent(t_tokens, location))
+			{
+				return false;
+			}
+			if (location.m_object != nullptr)
+			{
+				std::vector<Node::JSON_KVP>& members = std::get<std::vector<Node::JSON_KVP>>(location.m_object->m_kvp);
+				Node::JSON_KVP* member = find_member(*location.m_object, t_tokens.back());
+				if (member == nullptr)
+				{
+					return false;
+				}
+				if (t_removed != nullptr)
+				{
+					*t_removed = std::move(member->m_value);
+				}
+				members.erase(members.begin() + (member - members.data()));
+				mark_dirty(location.m_object);
+				return true;
+			}
+			size_t index = 0;
+			if (!read_index(t_tokens.back(), location.m_array->size(), false, index))
+			{
+				return false;
+			}
+			if (t_removed != nullptr)
+			{
+				*t_removed = std::move((*location.m_array)[index]);
+			}
+			location.m_array->erase(location.m_array->begin() + index);
+			mark_dirty(location.m_owner);
+			return true;
+		}
+
+		// Merges the members of a merge patch object into t_target.
+		void merge_object(Node& t_target, std::vector<Node::JSON_KVP>& t_patch)
+		{
+			std::vector<Node::JSON_KVP>& members = std::get<std::vector<Node::JSON_KVP>>(t_target.m_kvp);
+			for (Node::JSON_KVP& patch_member : t_patch)
+			{
+				Node::JSON_KVP* member = find_member(t_target, patch_member.m_key);
+				Node::JSON_Value* patch_value = &patch_member.m_value;
+				if (std::holds_alternative<std::nullptr_t>(patch_value->m_value_individual))
+				{
+					if (member != nullptr)
+					{
+						members.erase(members.begin() + (member - members.data()));
+						mark_dirty(&t_target);
+					}
+					continue;
+				}
+				std::shared_ptr<Node>* patch_node = std::get_if<std::shared_ptr<Node>>(&patch_value->m_value_individual);
+				std::vector<Node::JSON_KVP>* patch_node_members = patch_node == nullptr ? nullptr : std::get_if<std::vector<Node::JSON_KVP>>(&(*patch_node)->m_kvp);
+				if (patch_node_members != nullptr)
+				{
+					Node::JSON_Value* member_value = member == nullptr ? nullptr : &member->m_value;
+					std::shared_ptr<Node>* member_node = member_value == nullptr ? nullptr : std::get_if<std::shared_ptr<Node>>(&member_value->m_value_individual);
+					if (member_node != nullptr && std::holds_alternative<std::vector<Node::JSON_KVP>>((*member_node)->m_kvp))
+					{
+						merge_object(**member_node, *patch_node_members);
+						continue;
+					}
+					remove_nulls(**patch_node);
+				}
+				if (member != nullptr)
+				{
+					member->m_value = std::move(patch_member.m_value);
+					adopt_member(t_target, static_cast<size_t>(member - members.data()), false);
+				}
+				else
+				{
+					Node::JSON_KVP temp_kvp;
+					temp_kvp.m_key = patch_member.m_key;
+					temp_kvp.m_value = std::move(patch_member.m_value);
+					members.push_back(std::move(temp_kvp));
+					adopt_member(t_target, members.size() - 1, true);
+				}
+			}
+		}
+
+		// Drops null members from an object that is added by a merge patch, as if it were merged into an empty object.
+		static void remove_nulls(Node& t_node)
+		{
+			std::vector<Node::JSON_KVP>& members = std::get<std::vector<Node::JSON_KVP>>(t_node.m_kvp);
+			members.erase(std::remove_if(members.begin(), members.end(), [](const Node::JSON_KVP& t_kvp)
+				{
+					return std::holds_alternative<std::nullptr_t>(t_kvp.m_value.m_value_individual);
+				}), members.end());
+			for (Node::JSON_KVP& kvp : members)
+			{
+				std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&kvp.m_value.m_value_individual);
+				if (temp_node != nullptr && std::holds_alternative<std::vector<Node::JSON_KVP>>((*temp_node)->m_kvp))
+				{
+					remove_nulls(**temp_node);
+				}
+			}
+		}
+
+		static bool scalars_equal(const Node::JSON_Value& t_left, const Node::JSON_Value& t_right)
+		{
+			// numbers are equal if their values are equal, whether they are stored as int, double, or text
+			if (is_number(t_left) && is_number(t_right))
+			{
+				return numbers_equal(exact_number_of(t_left), exact_number_of(t_right));
+			}
+			if (t_left.m_value_individual.index() != t_right.m_value_individual.index())
+			{
+				return false;
+			}
+			if (const bool* temp_bool = std::get_if<bool>(&t_left.m_value_individual))
+			{
+				return *temp_bool == std::get<bool>(t_right.m_value_individual);
+			}
+			if (const std::string* temp_string = std::get_if<std::string>(&t_left.m_value_individual))
+			{
+				return *temp_string == std::get<std::string>(t_right.m_value_individual);
+			}
+			return std::holds_alternative<std::nullptr_t>(t_left.m_value_individual);
+		}
+
+		static double number_of(const Node::JSON_Value& t_value)
+		{
+			double output = 0;
+			read_number_value(t_value, output);
+			return output;
+		}
+
+		/*
+		* Reads a number as a double.
+		* @returns false if the number is outside the range of a double, in which case t_output is set to infinity or
+		* zero with the number's sign.
+		*/
+		static bool read_number_value(const Node::JSON_Value& t_value, double& t_output)
+		{
+			if (const int* temp_int = std::get_if<int>(&t_value.m_value_individual))
+			{
+				t_output = static_cast<double>(*temp_int);
+				return true;
+			}
+			const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual);
+			if (temp_number == nullptr)
+			{
+				t_output = std::get<double>(t_value.m_value_individual);
+				return true;
+			}
+			const std::string& text = temp_number->m_text;
+			if (std::from_chars(text.data(), text.data() + text.size(), t_output).ec == std::errc())
+			{
+				return true;
+			}
+			size_t exponent = text.find_first_of("eE");
+			const bool underflow = exponent != std::string::npos && exponent + 1 < text.size() && text[exponent + 1] == '-';
+			t_output = underflow ? 0.0 : std::numeric_limits<double>::infinity();
+			t_output = !text.empty() && text[0] == '-' ? -t_output : t_output;
+			return false;
+		}
+
+		/*
+		* Value of a number used to compare and hash numbers exactly. Integers are kept as 64 bit integers, doubles
+		* without a fraction are converted to them, and only other numbers are compared as doubles.
+		*/
+		struct Exact_Number
+		{
+			enum class Kind { SIGNED, UNSIGNED, FLOATING, OUT_OF_RANGE };
+
+			Kind m_kind = Kind::SIGNED;
+			long long m_signed = 0;
+			unsigned long long m_unsigned = 0;	// integers above the range of long long
+			double m_double = 0;
+			const std::string* m_text = nullptr;	// original text of a number outside the range of a double
+		};
+
+		static Exact_Number exact_number_of(const Node::JSON_Value& t_value)
+		{
+			Exact_Number number;
+			if (read_integer(t_value, number.m_signed))
+			{
+				return number;
+			}
+			if (read_integer(t_value, number.m_unsigned))
+			{
+				number.m_kind = Exact_Number::Kind::UNSIGNED;
+				return number;
+			}
+			double value = 0;
+			if (!read_number_value(t_value, value))
+			{
+				number.m_kind = Exact_Number::Kind::OUT_OF_RANGE;
+				number.m_text = &std::get<Node::JSON_Value::Number>(t_value.m_value_individual).m_text;
+				return number;
+			}
+			// the bounds are 2^63 and 2^64, which are exact as doubles
+			if (value >= -9223372036854775808.0 && value < 9223372036854775808.0 && static_cast<double>(static_cast<long long>(value)) == value)
+			{
+				number.m_signed = static_cast<long long>(value);
+			}
+			else if (value >= 9223372036854775808.0 && value < 18446744073709551616.0 && static_cast<double>(static_cast<unsigned long long>(value)) == value)
+			{
+				number.m_kind = Exact_Number::Kind::UNSIGNED;
+				number.m_unsigned = static_cast<unsigned long long>(value);
+			}
+			else
+			{
+				number.m_kind = Exact_Number::Kind::FLOATING;
+				number.m_double = value;
+			}
+			return number;
+		}
+
+		// Numbers outside the range of a double are only equal to numbers with the same text.
+		static bool numbers_equal(const Exact_Number& t_left, const Exact_Number& t_right)
+		{
+			if (t_left.m_kind != t_right.m_kind)
+			{
+				return false;
+			}
+			switch (t_left.m_kind)
+			{
+			case Exact_Number::Kind::SIGNED: return t_left.m_signed == t_right.m_signed;
+			case Exact_Number::Kind::UNSIGNED: return t_left.m_unsigned == t_right.m_unsigned;
+			case Exact_Number::Kind::FLOATING: return t_left.m_double == t_right.m_double;
+			default: return *t_left.m_text == *t_right.m_text;
+			}
+		}
+
+		// Deep comparison. Object members may be in any order, array elements must be in the same order.
+		static bool values_equal(const Value_Ref& t_left, const Value_Ref& t_right)
+		{
+			if (t_left.m_object != nullptr || t_right.m_object != nullptr)
+			{
+				return t_left.m_object != nullptr && t_right.m_object != nullptr && objects_equal(*t_left.m_object, *t_right.m_object);
+			}
+			if (t_left.m_elements != nullptr || t_right.m_elements != nullptr)
+			{
+				return t_left.m_elements != nullptr && t_right.m_elements != nullptr && arrays_equal(*t_left.m_elements, *t_right.m_elements);
+			}
+			return scalars_equal(*t_left.m_scalar, *t_right.m_scalar);
+		}
+
+		static bool arrays_equal(const std::vector<Node::JSON_Value>& t_left, const std::vector<Node::JSON_Value>& t_right)
+		{
+			if (&t_left == &t_right)
+			{
+				return true;
+			}
+			std::vector<Node::JSON_Value>::const_iterator left = t_left.begin();
+			std::vector<Node::JSON_Value>::const_iterator right = t_right.begin();
+			while (true)
+			{
+				while (left != t_left.end() && left->m_removed)
+				{
+					left++;
+				}
+				while (right != t_right.end() && right->m_removed)
+				{
+					right++;
+				}
+				if (left == t_left.end() || right == t_right.end())
+				{
+					return left == t_left.end() && right == t_right.end();
+				}
+				if (!values_equal(make_ref(*left), make_ref(*right)))
+				{
+					return false;
+				}
+				left++;
+				right++;
+			}
+		}
+
+		static bool objects_equal(const Node& t_left, const Node& t_right)
+		{
+			if (&t_left == &t_right)
+			{
+				return true;
+			}
+			size_t left_hash = 0;
+			size_t right_hash = 0;
+			if (t_left.m_hash.get(left_hash) && t_right.m_hash.get(right_hash) && left_hash != right_hash)
+			{
+				return false;
+			}
+			const std::vector<Node::JSON_KVP>* left_members = std::get_if<std::vector<Node::JSON_KVP>>(&t_left.m_kvp);
+			const std::vector<Node::JSON_KVP>* right_members = std::get_if<std::vector<Node::JSON_KVP>>(&t_right.m_kvp);
+			if (left_members == nullptr || right_members == nullptr)
+			{
+				return left_members == right_members;
+			}
+			std::unordered_map<std::string, const Node::JSON_KVP*> right_by_key;
+			for (const Node::JSON_KVP& kvp : *right_members)
+			{
+				if (!kvp.m_removed)
+				{
+					right_by_key.emplace(kvp.m_key, &kvp);
+				}
+			}
+			size_t left_count = 0;
+			for (const Node::JSON_KVP& kvp : *left_members)
+			{
+				if (kvp.m_removed)
+				{
+					continue;
+				}
+				left_count++;
+				auto match = right_by_key.find(kvp.m_key);
+				if (match == right_by_key.end() || !values_equal(make_ref(kvp.m_value), make_ref(match->second->m_value)))
+				{
+					return false;
+				}
+			}
+			return left_count == right_by_key.size();
+		}
+
+
+		//************************************************* DIFF ************************************************\\
+
+	public:
+		/*
+		* Computes an RFC 6902 JSON Patch that turns t_from into t_to. Object members are matched by key through a
+		* hash map and array elements by position. Objects with different content hashes are diffed member by member.
+		* Objects with equal hashes are compared with objects_equal() and only skipped if their content is equal,
+		* so a hash collision cannot drop operations from the patch.
+		* Values in the patch are copies, so both documents are left unchanged.
+		* @returns A JSON array of operations that can be passed to apply_patch().
+		*/
+		static JSON diff(const JSON& t_from, const JSON& t_to)
+		{
+			std::vector<Node::JSON_Value> operations;
+			std::string path;
+			diff_values(root_ref(t_from.main_list), root_ref(t_to.main_list), path, operations);
+
+			JSON temp_patch;
+			std::vector<Node::JSON_KVP> root_vector(1);
+			root_vector[0].m_value.m_value_individual = std::move(operations);
+			temp_patch.main_list.m_kvp = std::move(root_vector);
+			temp_patch.relink_root();
+			return temp_patch;
+		}
+
+	private:
+		static Value_Ref root_ref(const Node& t_root)
+		{
+			Value_Ref temp_ref;
+			temp_ref.m_elements = root_array(t_root);
+			temp_ref.m_object = temp_ref.m_elements == nullptr ? &t_root : nullptr;
+			return temp_ref;
+		}
+
+		// Appends a pointer token to t_path, escaping '~' and '/' as RFC 6901 requires.
+		static void append_token(std::string& t_path, const std::string& t_token)
+		{
+			t_path += '/';
+			for (char c : t_token)
+			{
+				if (c == '~')
+				{
+					t_path += "~0";
+				}
+				else if (c == '/')
+				{
+					t_path += "~1";
+				}
+				else
+				{
+					t_path += c;
+				}
+			}
+		}
+
+		static void add_operation(std::vector<Node::JSON_Value>& t_operations, const char* t_op, const std::string& t_path, const Value_Ref* t_value)
+		{
+			std::vector<Node::JSON_KVP> members(t_value == nullptr ? 2 : 3);
+			members[0].m_key = "op";
+			members[0].m_value = make_string_value(t_op);
+			members[1].m_key = "path";
+			members[1].m_value = make_string_value(t_path);
+			if (t_value != nullptr)
+			{
+				members[2].m_key = "value";
+				members[2].m_value = clone_ref(*t_value);
+			}
+			std::shared_ptr<Node> temp_node_object(new Node);
+			temp_node_object->m_kvp = std::move(members);
+			link_children(*temp_node_object);
+			Node::JSON_Value temp_value;
+			temp_value.m_value_individual = std::move(temp_node_object);
+			t_operations.push_back(std::move(temp_value));
+		}
+
+		// Strings are stored with their quotes, the same way the parser stores them.
+		static Node::JSON_Value make_string_value(const std::string& t_string)
+		{
+			std::string quoted_value;
+			quoted_value.reserve(t_string.size() + 2);
+			write_escaped_string(quoted_value, t_string);
+			Node::JSON_Value temp_value;
+			temp_value.m_value_individual = std::move(quoted_value);
+			return temp_value;
+		}
+
+		static void diff_values(const Value_Ref& t_from, const Value_Ref& t_to, std::string& t_path, std::vector<Node::JSON_Value>& t_operations)
+		{
+			if (t_from.m_object != nullptr && t_to.m_object != nullptr)
+			{
+				// a hash mismatch proves a difference, equal hashes still have to be confirmed
+				if (t_from.m_object != t_to.m_object && (hash_node(*t_from.m_object) != hash_node(*t_to.m_object) || !objects_equal(*t_from.m_object, *t_to.m_object)))
+				{
+					diff_objects(*t_from.m_object, *t_to.m_object, t_path, t_operations);
+				}
+			}
+			else if (t_from.m_elements != nullptr && t_to.m_elements != nullptr)
+			{
+				if (t_from.m_elements != t_to.m_elements)
+				{
+					diff_arrays(*t_from.m_elements, *t_to.m_elements, t_path, t_operations);
+				}
+			}
+			else if (t_from.m_scalar == nullptr || t_to.m_scalar == nullptr || !scalars_equal(*t_from.m_scalar, *t_to.m_scalar))
+			{
+				add_operation(t_operations, "replace", t_path, &t_to);
+			}
+		}
+
+		static void diff_objects(const Node& t_from, const Node& t_to, std::string& t_path, std::vector<Node::JSON_Value>& t_operations)
+		{
+			const std::vector<Node::JSON_KVP>* from_members = std::get_if<std::vector<Node::JSON_KVP>>(&t_from.m_kvp);
+			const std::vector<Node::JSON_KVP>* to_members = std::get_if<std::vector<Node::JSON_KVP>>(&t_to.m_kvp);
+			std::vector<Node::JSON_KVP> no_members;
+			if (from_members == nullptr)
+			{
+				from_members = &no_members;
+			}
+			if (to_members == nullptr)
+			{
+				to_members = &no_members;
+			}
+
+			std::unordered_map<std::string, const Node::JSON_KVP*> to_by_key;
+			to_by_key.reserve(to_members->size());
+			for (const Node::JSON_KVP& kvp : *to_members)
+			{
+				if (!kvp.m_removed)
+				{
+					to_by_key.emplace(kvp.m_key, &kvp);
+				}
+			}
+
+			size_t path_length = t_path.size();
+			std::unordered_set<std::string> from_keys;
+			from_keys.reserve(from_members->size());
+			for (const Node::JSON_KVP& kvp : *from_members)
+			{
+				if (kvp.m_removed || !from_keys.insert(kvp.m_key).second)
+				{
+					continue;
+				}
+				append_token(t_path, kvp.m_key);
+				auto match = to_by_key.find(kvp.m_key);
+				if (match == to_by_key.end())
+				{
+					add_operation(t_operations, "remove", t_path, nullptr);
+				}
+				else
+				{
+					diff_values(make_ref(kvp.m_value), make_ref(match->second->m_value), t_path, t_operations);
+				}
+				t_path.resize(path_length);
+			}
+			for (const Node::JSON_KVP& kvp : *to_members)
+			{
+				if (kvp.m_removed || from_keys.count(kvp.m_key) > 0 || to_by_key[kvp.m_key] != &kvp)
+				{
+					continue;
+				}
+				append_token(t_path, kvp.m_key);
+				Value_Ref added = make_ref(kvp.m_value);
+				add_operation(t_operations, "add", t_path, &added);
+				t_path.resize(path_length);
+			}
+		}
+
+		// Elements are compared by position. Extra elements are appended or removed from the end.
+		static void diff_arrays(const std::vector<Node::JSON_Value>& t_from, const std::vector<Node::JSON_Value>& t_to, std::string& t_path, std::vector<Node::JSON_Value>& t_operations)
+		{
+			std::vector<const Node::JSON_Value*> from_elements;
+			std::vector<const Node::JSON_Value*> to_elements;
+			for (const Node::JSON_Value& element : t_from)
+			{
+				if (!element.m_removed)
+				{
+					from_elements.push_back(&element);
+				}
+			}
+			for (const Node::JSON_Value& element : t_to)
+			{
+				if (!element.m_removed)
+				{
+					to_elements.push_back(&element);
+				}
+			}
+
+			size_t path_length = t_path.size();
+			size_t common = std::min(from_elements.size(), to_elements.size());
+			for (size_t i = 0; i < common; i++)
+			{
+				append_token(t_path, std::to_string(i));
+				diff_values(make_ref(*from_elements[i]), make_ref(*to_elements[i]), t_path, t_operations);
+				t_path.resize(path_length);
+			}
+			for (size_t i = common; i < to_elements.size(); i++)
+			{
+				append_token(t_path, "-");
+				Value_Ref added = make_ref(*to_elements[i]);
+				add_operation(t_operations, "add", t_path, &added);
+				t_path.resize(path_length);
+			}
+			for (size_t i = from_elements.size(); i > common; i--)
+			{
+				append_token(t_path, std::to_string(i - 1));
+				add_operation(t_operations, "remove", t_path, nullptr);
+				t_path.resize(path_length);
+			}
+		}
+
+
+		//************************************************* HASH ************************************************\\
+
+	public:
+		/*
+		* Returns a hash of the content of the JSON structure. Equal documents have equal hashes regardless of the
+		* order of object members, and numbers are hashed by value so 1 and 1.0 hash the same. The hash of every
+		* object is cached and invalidated by the update and delete methods, so after a change only the changed
+		* objects and the objects that contain them are hashed again. The cache is atomic, so a const JSON can be
+		* hashed and compared from several threads at once.
+		*/
+		size_t hash() const
+		{
+			return hash_node(main_list);
+		}
+
+		/*
+		* Deep equality. Object members may be in any order. Documents with different hashes are rejected without
+		* being compared, and objects shared by both documents are not visited.
+		*/
+		friend bool operator==(const JSON& t_left, const JSON& t_right)
+		{
+			return t_left.hash() == t_right.hash() && values_equal(root_ref(t_left.main_list), root_ref(t_right.main_list));
+		}
+
+		friend bool operator!=(const JSON& t_left, const JSON& t_right)
+		{
+			return !(t_left == t_right);
+		}
+
+	private:
+		static constexpr uint64_t k_object_seed = 0x6a09e667f3bcc909ULL;
+		static constexpr uint64_t k_array_seed = 0xbb67ae8584caa73bULL;
+		static constexpr uint64_t k_null_hash = 0x3c6ef372fe94f82bULL;
+		static constexpr uint64_t k_true_hash = 0xa54ff53a5f1d36f1ULL;
+		static constexpr uint64_t k_false_hash = 0x510e527fade682d1ULL;
+
+		// Finalizer from splitmix64, spreads every input bit over the whole result.
+		static uint64_t mix_hash(uint64_t t_value) noexcept
+		{
+			t_value ^= t_value >> 30;
+			t_value *= 0xbf58476d1ce4e5b9ULL;
+			t_value ^= t_value >> 27;
+			t_value *= 0x94d049bb133111ebULL;
+			t_value ^= t_value >> 31;
+			return t_value;
+		}
+
+		// Members are summed so the hash does not depend on their order.
+		static size_t hash_node(const Node& t_node)
+		{
+			size_t cached_hash = 0;
+			if (t_node.m_hash.get(cached_hash))
+			{
+				return cached_hash;
+			}
+			uint64_t hash = k_object_seed;
+			if (const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp))
+			{
+				for (const Node::JSON_KVP& kvp : *temp_kvp_array)
+				{
+					if (!kvp.m_removed)
+					{
+						hash += mix_hash(std::hash<std::string>()(kvp.m_key) ^ mix_hash(hash_ref(make_ref(kvp.m_value))));
+					}
+				}
+			}
+			t_node.m_hash.set(static_cast<size_t>(hash));
+			return static_cast<size_t>(hash);
+		}
+
+		static size_t hash_array(const std::vector<Node::JSON_Value>& t_array)
+		{
+			uint64_t hash = k_array_seed;
+			for (const Node::JSON_Value& element : t_array)
+			{
+				if (!element.m_removed)
+				{
+					hash = mix_hash(hash ^ hash_ref(make_ref(element)));
+				}
+			}
+			return static_cast<size_t>(hash);
+		}
+
+		static size_t hash_ref(const Value_Ref& t_value)
+		{
+			if (t_value.m_object != nullptr)
+			{
+				return hash_node(*t_value.m_object);
+			}
+			if (t_value.m_elements != nullptr)
+			{
+				return hash_array(*t_value.m_elements);
+			}
+			const Node::JSON_Value& scalar = *t_value.m_scalar;
+			if (is_number(scalar))
+			{
+				// hashes the same representation numbers_equal() compares, so equal numbers have equal hashes
+				Exact_Number number = exact_number_of(scalar);
+				switch (number.m_kind)
+				{
+				case Exact_Number::Kind::SIGNED: return std::hash<long long>()(number.m_signed);
+				case Exact_Number::Kind::UNSIGNED: return std::hash<unsigned long long>()(number.m_unsigned);
+				case Exact_Number::Kind::FLOATING: return std::hash<double>()(number.m_double);
+				default: return std::hash<std::string>()(*number.m_text);
+				}
+			}
+			if (const bool* temp_bool = std::get_if<bool>(&scalar.m_value_individual))
+			{
+				return static_cast<size_t>(*temp_bool ? k_true_hash : k_false_hash);
+			}
+			if (const std::string* temp_string = std::get_if<std::string>(&scalar.m_value_individual))
+			{
+				return std::hash<std::string>()(*temp_string);
+			}
+			return static_cast<size_t>(k_null_hash);
+		}
+
+
+		//*********************************************** MESSAGEPACK *******************************************\\
+
+	public:
+		/*
+		* Encodes the JSON structure as MessagePack. Numbers are written in binary and strings are length prefixed,
+		* so decoding needs no scanning. Integers use the smallest encoding that holds them and doubles are written
+		* as float64.
+		* @returns The encoded bytes.
+		*/
+		static std::string to_msgpack(const JSON& t_main_list)
+		{
+			std::string output;
+			if (const std::vector<Node::JSON_Value>* temp_array = root_array(t_main_list.main_list))
+			{
+				write_msgpack_array(*temp_array, output);
+			}
+			else if (std::holds_alternative<std::vector<Node::JSON_KVP>>(t_main_list.main_list.m_kvp))
+			{
+				write_msgpack_node(t_main_list.main_list, output);
+			}
+			else
+			{
+				output.push_back(static_cast<char>(0xc0));
+			}
+			return output;
+		}
+
+		/*
+		* Decodes MessagePack into a JSON structure without going through text. Map keys must be strings, and the
+		* bin and ext types are rejected because they have no JSON equivalent.
+		* @param t_bytes Encoded bytes, for example from to_msgpack().
+		* @returns A JSON object, or an empty JSON object if the input is malformed.
+		*/
+		static JSON from_msgpack(const std::string& t_bytes)
+		{
+			JSON temp_list;
+			Document_Builder builder(temp_list.main_list);
+			const uint8_t* begin = reinterpret_cast<const uint8_t*>(t_bytes.data());
+			if (!scan_msgpack(begin, begin + t_bytes.size(), builder))
+			{
+				temp_list.main_list.m_kvp = std::monostate();
+			}
+			return temp_list;
+		}
+
+	private:
+		static void write_big_endian(std::string& t_output, const uint64_t t_value, const int t_bytes)
+		{
+			for (int shift = (t_bytes - 1) * 8; shift >= 0; shift -= 8)
+			{
+				t_output.push_back(static_cast<char>((t_value >> shift) & 0xFF));
+			}
+		}
+
+		static uint64_t read_big_endian(const uint8_t* t_input, const int t_bytes) noexcept
+		{
+			uint64_t value = 0;
+			for (int i = 0; i < t_bytes; i++)
+			{
+				value = (value << 8) | t_input[i];
+			}
+			return value;
+		}
+
+		static void write_msgpack_int(const long long t_value, std::string& t_output)
+		{
+			if (t_value >= 0 && t_value < 0x80)
+			{
+				t_output.push_back(static_cast<char>(t_value));
+			}
+			else if (t_value < 0 && t_value >= -32)
+			{
+				t_output.push_back(static_cast<char>(t_value));
+			}
+			else if (t_value >= INT8_MIN && t_value <= INT8_MAX)
+			{
+				t_output.push_back(static_cast<char>(0xd0));
+				write_big_endian(t_output, static_cast<uint64_t>(t_value), 1);
+			}
+			else if (t_value >= INT16_MIN && t_value <= INT16_MAX)
+			{
+				t_output.push_back(static_cast<char>(0xd1));
+				write_big_endian(t_output, static_cast<uint64_t>(t_value), 2);
+			}
+			else if (t_value >= INT32_MIN && t_value <= INT32_MAX)
+			{
+				t_output.push_back(static_cast<char>(0xd2));
+				write_big_endian(t_output, static_cast<uint64_t>(t_value), 4);
+			}
+			else
+			{
+				t_output.push_back(static_cast<char>(0xd3));
+				write_big_endian(t_output, static_cast<uint64_t>(t_value), 8);
+			}
+		}
+
+		// Writes a container or string header using the fix, 8, 16, or 32 bit length form.
+		static void write_msgpack_header(std::string& t_output, const size_t t_size, const uint8_t t_fix_type, const size_t t_fix_limit, const uint8_t t_type8, const uint8_t t_type16, const uint8_t t_type32)
+		{
+			if (t_size < t_fix_limit)
+			{
+				t_output.push_back(static_cast<char>(t_fix_type | t_size));
+			}
+			else if (t_type8 != 0 && t_size <= UINT8_MAX)
+			{
+				t_output.push_back(static_cast<char>(t_type8));
+				write_big_endian(t_output, t_size, 1);
+			}
+			else if (t_size <= UINT16_MAX)
+			{
+				t_output.push_back(static_cast<char>(t_type16));
+				write_big_endian(t_output, t_size, 2);
+			}
+			else
+			{
+				t_output.push_back(static_cast<char>(t_type32));
+				write_big_endian(t_output, t_size, 4);
+			}
+		}
+
+		static void write_msgpack_string(const std::string& t_string, std::string& t_output)
+		{
+			write_msgpack_header(t_output, t_string.size(), 0xa0, 32, 0xd9, 0xda, 0xdb);
+			t_output += t_string;
+		}
+
+		/*
+		* Returns the text of a string value. Values from the parser keep their quotes and escape sequences, values
+		* set with update_value() are stored as given.
+		*/
+		static void read_stored_string(const std::string& t_stored, std::string& t_output)
+		{
+			if (t_stored.size() < 2 || t_stored.front() != '"' || t_stored.back() != '"')
+			{
+				t_output = t_stored;
+				return;
+			}
+			if (std::memchr(t_stored.data(), '\\', t_stored.size()) == nullptr)
+			{
+				t_output.assign(t_stored, 1, t_stored.size() - 2);
+				return;
+			}
+			Scanner scanner(t_stored.data(), t_stored.data() + t_stored.size());
+			if (!scanner.read_string(t_output))
+			{
+				t_output = t_stored;
+			}
+		}
+
+		static void write_msgpack_value(const Node::JSON_Value& t_value, std::string& t_output)
+		{
+			long long temp_integer = 0;
+			unsigned long long temp_unsigned = 0;
+			if (read_integer(t_value, temp_integer))
+			{
+				write_msgpack_int(temp_integer, t_output);
+			}
+			else if (read_integer(t_value, temp_unsigned)) // above the range of long long
+			{
+				t_output.push_back(static_cast<char>(0xcf));
+				write_big_endian(t_output, temp_unsigned, 8);
+			}
+			else if (is_number(t_value))
+			{
+				double number = number_of(t_value);
+				uint64_t bits = 0;
+				std::memcpy(&bits, &number, sizeof(bits));
+				t_output.push_back(static_cast<char>(0xcb));
+				write_big_endian(t_output, bits, 8);
+			}
+			else if (const bool* temp_bool = std::get_if<bool>(&t_value.m_value_individual))
+			{
+				t_output.push_back(static_cast<char>(*temp_bool ? 0xc3 : 0xc2));
+			}
+			else if (const std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual))
+			{
+				std::string text;
+				read_stored_string(*temp_string, text);
+				write_msgpack_string(text, t_output);
+			}
+			else if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				write_msgpack_node(**temp_node, t_output);
+			}
+			else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				write_msgpack_array(*temp_array, t_output);
+			}
+			else
+			{
+				t_output.push_back(static_cast<char>(0xc0));
+			}
+		}
+
+		static void write_msgpack_array(const std::vector<Node::JSON_Value>& t_array, std::string& t_output)
+		{
+			size_t count = std::count_if(t_array.begin(), t_array.end(), [](const Node::JSON_Value& t_element) { return !t_element.m_removed; });
+			write_msgpack_header(t_output, count, 0x90, 16, 0, 0xdc, 0xdd);
+			for (const Node::JSON_Value& element : t_array)
+			{
+				if (!element.m_removed)
+				{
+					write_msgpack_value(element, t_output);
+				}
+			}
+		}
+
+		static void write_msgpack_node(const Node& t_node, std::string& t_output)
+		{
+			const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp);
+			if (temp_kvp_array == nullptr)
+			{
+				t_output.push_back(static_cast<char>(0xc0));
+				return;
+			}
+			size_t count = std::count_if(temp_kvp_array->begin(), temp_kvp_array->end(), [](const Node::JSON_KVP& t_kvp) { return !t_kvp.m_removed; });
+			write_msgpack_header(t_output, count, 0x80, 16, 0, 0xde, 0xdf);
+			for (const Node::JSON_KVP& kvp : *temp_kvp_array)
+			{
+				if (kvp.m_removed)
+				{
+					continue;
+				}
+				write_msgpack_string(kvp.m_key, t_output);
+				write_msgpack_value(kvp.m_value, t_output);
+			}
+		}
+
+		// Reads a string of any MessagePack string type into t_output.
+		static bool read_msgpack_string(const uint8_t*& t_current, const uint8_t* t_end, std::string& t_output)
+		{
+			if (t_current >= t_end)
+			{
+				return false;
+			}
+			uint8_t type = *t_current++;
+			size_t length = 0;
+			int length_bytes = 0;
+			if ((type & 0xe0) == 0xa0)
+			{
+				length = type & 0x1f;
+			}
+			else if (type >= 0xd9 && type <= 0xdb)
+			{
+				length_bytes = 1 << (type - 0xd9);
+			}
+			else
+			{
+				return false;
+			}
+			if (t_end - t_current < length_bytes)
+			{
+				return false;
+			}
+			if (length_bytes > 0)
+			{
+				length = static_cast<size_t>(read_big_endian(t_current, length_bytes));
+				t_current += length_bytes;
+			}
+			if (static_cast<size_t>(t_end - t_current) < length)
+			{
+				return false;
+			}
+			t_output.assign(reinterpret_cast<const char*>(t_current), length);
+			t_current += length;
+			return true;
+		}
+
+		/*
+		* Reports the contents of MessagePack input to a handler as parse events, so from_msgpack() can build the
+		* JSON structure with the same Document_Builder as parse(). Containers are tracked on an explicit stack.
+		* @returns false if the input is malformed. Stopping early from the handler is not an error.
+		*/
+		template<typename Handler>
+		static bool scan_msgpack(const uint8_t* t_begin, const uint8_t* t_end, Handler& t_handler)
+		{
+			struct Level
+			{
+				uint32_t m_remaining;	// pairs of a map or elements of an array still to be read
+				bool m_is_map;
+			};
+			std::vector<Level> stack;
+			std::string buffer;
+			const uint8_t* current = t_begin;
+			while (true)
+			{
+				if (!stack.empty() && stack.back().m_is_map)
+				{
+					if (!read_msgpack_string(current, t_end, buffer))
+					{
+						return false;
+					}
+					if (!t_handler.key(buffer)) { return true; }
+				}
+				if (current >= t_end)
+				{
+					return false;
+				}
+
+				uint8_t type = *current++;
+				const uint8_t* payload = current;
+				bool stopped = false;
+				bool value_complete = true;
+				int payload_bytes = 0;
+				uint32_t container_size = 0;
+				int container = 0; // 1 for a map, 2 for an array
+				if (type < 0x80 || type >= 0xe0)
+				{
+					stopped = !t_handler.int_value(static_cast<int>(static_cast<int8_t>(type)));
+				}
+				else if ((type & 0xf0) == 0x80 || (type & 0xf0) == 0x90)
+				{
+					container = (type & 0xf0) == 0x80 ? 1 : 2;
+					container_size = type & 0x0f;
+				}
+				else if ((type & 0xe0) == 0xa0 || (type >= 0xd9 && type <= 0xdb))
+				{
+					current--;
+					if (!read_msgpack_string(current, t_end, buffer))
+					{
+						return false;
+					}
+					stopped = !t_handler.string_value(buffer);
+				}
+				else if (type == 0xc0)
+				{
+					stopped = !t_handler.null_value();
+				}
+				else if (type == 0xc2 || type == 0xc3)
+				{
+					stopped = !t_handler.bool_value(type == 0xc3);
+				}
+				else if (type == 0xca || type == 0xcb)
+				{
+					payload_bytes = type == 0xca ? 4 : 8;
+				}
+				else if (type >= 0xcc && type <= 0xd3)
+				{
+					payload_bytes = 1 << ((type - 0xcc) & 3);
+				}
+				else if (type == 0xdc || type == 0xde)
+				{
+					payload_bytes = 2;
+					container = type == 0xde ? 1 : 2;
+				}
+				else if (type == 0xdd || type == 0xdf)
+				{
+					payload_bytes = 4;
+					container = type == 0xdf ? 1 : 2;
+				}
+				else
+				{
+					return false; // bin, ext, and reserved types
+				}
+
+				if (payload_bytes > 0)
+				{
+					if (t_end - payload < payload_bytes)
+					{
+						return false;
+					}
+					uint64_t bits = read_big_endian(payload, payload_bytes);
+					current = payload + payload_bytes;
+					if (container != 0)
+					{
+						container_size = static_cast<uint32_t>(bits);
+					}
+					else if (type == 0xca)
+					{
+						uint32_t bits32 = static_cast<uint32_t>(bits);
+						float number = 0;
+						std::memcpy(&number, &bits32, sizeof(number));
+						stopped = !t_handler.double_value(number);
+					}
+					else if (type == 0xcb)
+					{
+						double number = 0;
+						std::memcpy(&number, &bits, sizeof(number));
+						stopped = !t_handler.double_value(number);
+					}
+					else
+					{
+						stopped = !report_msgpack_int(type, bits, payload_bytes, t_handler);
+					}
+				}
+
+				if (container != 0)
+				{
+					if (!(container == 1 ? t_handler.start_object() : t_handler.start_array())) { return true; }
+					if (container_size > 0)
+					{
+						stack.push_back(Level{ container_size, container == 1 });
+						value_complete = false;
+					}
+					else if (!(container == 1 ? t_handler.end_object() : t_handler.end_array()))
+					{
+						return true;
+					}
+				}
+				if (stopped)
+				{
+					return true;
+				}
+				if (!value_complete)
+				{
+					continue;
+				}
+
+				// close any containers that end after this value
+				while (true)
+				{
+					if (stack.empty())
+					{
+						return current == t_end;
+					}
+					if (--stack.back().m_remaining > 0)
+					{
+						break;
+					}
+					bool is_map = stack.back().m_is_map;
+					stack.pop_back();
+					if (!(is_map ? t_handler.end_object() : t_handler.end_array())) { return true; }
+				}
+			}
+		}
+
+		/*
+		* Reports an integer as an int if it fits in one. Larger integers are reported to number_text() as exact text
+		* when the handler has it, the same as numbers in parse_events(), and as doubles otherwise.
+		*/
+		template<typename Handler>
+		static bool report_msgpack_int(const uint8_t t_type, const uint64_t t_bits, const int t_bytes, Handler& t_handler)
+		{
+			if (t_type <= 0xcf) // unsigned
+			{
+				if (t_bits <= static_cast<uint64_t>(INT_MAX))
+				{
+					return t_handler.int_value(static_cast<int>(t_bits));
+				}
+				return report_msgpack_large_int(t_bits, t_handler);
+			}
+			// sign extend from the encoded width
+			int64_t value = t_bytes == 8 ? static_cast<int64_t>(t_bits) : static_cast<int64_t>(t_bits << (64 - t_bytes * 8)) >> (64 - t_bytes * 8);
+			if (value >= INT_MIN && value <= INT_MAX)
+			{
+				return t_handler.int_value(static_cast<int>(value));
+			}
+			return report_msgpack_large_int(value, t_handler);
+		}
+
+		template<typename T, typename Handler>
+		static bool report_msgpack_large_int(const T t_value, Handler& t_handler)
+		{
+			if constexpr (has_number_text<Handler>::value)
+			{
+				char buffer[24];
+				std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), t_value);
+				return t_handler.number_text(buffer, result.ptr);
+			}
+			else
+			{
+				return t_handler.double_value(static_cast<double>(t_value));
+			}
+		}
+
+
+		//************************************************* IMAGE ***********************************************\\
+
+	private:
+		/*
+		* Fixed size record describing one value in a document image. Scalars are stored inline, strings, arrays, and
+		* objects store the offset of their contents from the start of the image, so an image contains no pointers.
+		*/
+		struct Image_Slot
+		{
+			uint8_t m_type = static_cast<uint8_t>(Extracted_Value::Type::MISSING);
+			uint8_t m_padding[3] = {};
+			uint32_t m_count = 0;	// length of a string, or number of elements or members
+			uint64_t m_payload = 0;	// value of a scalar, or offset of the contents
+		};
+		static_assert(sizeof(Image_Slot) == 16, "Image_Slot must have the same layout on every compiler");
+
+		// Header: magic, byte order mark, version, image size, root slot. Object members are key offset, key length, padding, slot.
+		static constexpr size_t k_image_header_size = 40;
+		static constexpr size_t k_image_entry_size = 32;
+		static constexpr uint32_t k_image_byte_order = 0x01020304;
+		static constexpr uint32_t k_image_version = 1;
+		static constexpr char k_image_magic[9] = "JSONATOR";
+
+	public:
+		/*
+		* Read-only value inside a document image. Reads go directly to the image memory and allocate nothing.
+		* Every offset is bounds checked, so a damaged image gives MISSING values instead of reading out of range.
+		* A value is only valid while the image memory is.
+		*/
+		class Image_Value
+		{
+			friend class JSON;
+		private:
+			const char* m_image = nullptr;
+			size_t m_size = 0;
+			Image_Slot m_slot;
+
+			Image_Value(const char* t_image, const size_t t_size, const Image_Slot& t_slot) noexcept : m_image(t_image), m_size(t_size), m_slot(t_slot) {}
+
+			// Returns true if t_count records of t_record_size bytes fit at the slot's payload offset.
+			bool contents_fit(const size_t t_record_size) const noexcept
+			{
+				return m_slot.m_payload <= m_size && m_slot.m_count <= (m_size - m_slot.m_payload) / t_record_size;
+			}
+
+			Image_Value read_value(const size_t t_offset) const noexcept
+			{
+				Image_Slot temp_slot;
+				std::memcpy(&temp_slot, m_image + t_offset, sizeof(temp_slot));
+				return Image_Value(m_image, m_size, temp_slot);
+			}
+
+			// Returns the key of member t_index, which must be in range.
+			std::string_view read_key(const size_t t_index) const noexcept
+			{
+				uint64_t key_offset = 0;
+				uint32_t key_length = 0;
+				size_t entry = static_cast<size_t>(m_slot.m_payload) + t_index * k_image_entry_size;
+				std::memcpy(&key_offset, m_image + entry, sizeof(key_offset));
+				std::memcpy(&key_length, m_image + entry + sizeof(key_offset), sizeof(key_length));
+				if (key_offset > m_size || key_length > m_size - key_offset)
+				{
+					return std::string_view();
+				}
+				return std::string_view(m_image + key_offset, key_length);
+			}
+
+		public:
+			Image_Value() = default;
+
+			Extracted_Value::Type type() const noexcept
+			{
+				return static_cast<Extracted_Value::Type>(m_slot.m_type);
+			}
+
+			bool found() const noexcept
+			{
+				return type() != Extracted_Value::Type::MISSING;
+			}
+
+			// Returns the number of elements of an array or members of an object, or 0 otherwise.
+			size_t size() const noexcept
+			{
+				return type() == Extracted_Value::Type::ARRAY || type() == Extracted_Value::Type::OBJECT ? m_slot.m_count : 0;
+			}
+
+			// Returns the element at t_index of an array, or the value of member t_index of an object.
+			Image_Value an(const size_t t_index) const noexcept
+			{
+				if (t_index >= size())
+				{
+					return Image_Value();
+				}
+				if (type() == Extracted_Value::Type::ARRAY)
+				{
+					return contents_fit(sizeof(Image_Slot)) ? read_value(static_cast<size_t>(m_slot.m_payload) + t_index * sizeof(Image_Slot)) : Image_Value();
+				}
+				return contents_fit(k_image_entry_size) ? read_value(static_cast<size_t>(m_slot.m_payload) + t_index * k_image_entry_size + 16) : Image_Value();
+			}
+
+			// Returns the key of member t_index of an object. Members are sorted by key.
+			std::string_view key(const size_t t_index) const noexcept
+			{
+				if (type() != Extracted_Value::Type::OBJECT || t_index >= size() || !contents_fit(k_image_entry_size))
+				{
+					return std::string_view();
+				}
+				return read_key(t_index);
+			}
+
+			// Returns the value of a member of an object by binary search over the sorted keys.
+			Image_Value dn(const std::string_view t_key) const noexcept
+			{
+				if (type() != Extracted_Value::Type::OBJECT || !contents_fit(k_image_entry_size))
+				{
+					return Image_Value();
+				}
+				size_t low = 0;
+				size_t high = m_slot.m_count;
+				while (low < high)
+				{
+					size_t middle = low + (high - low) / 2;
+					if (read_key(middle) < t_key)
+					{
+						low = middle + 1;
+					}
+					else
+					{
+						high = middle;
+					}
+				}
+				if (low < m_slot.m_count && read_key(low) == t_key)
+				{
+					return an(low);
+				}
+				return Image_Value();
+			}
+
+			// Returns the integer or -1 if the value is not an integer.
+			long long as_int() const noexcept
+			{
+				return type() == Extracted_Value::Type::INTEGER ? static_cast<long long>(m_slot.m_payload) : -1;
+			}
+
+			// Returns the number or -1 if the value is not a number.
+			double as_double() const noexcept
+			{
+				if (type() == Extracted_Value::Type::DOUBLE)
+				{
+					double number = 0;
+					std::memcpy(&number, &m_slot.m_payload, sizeof(number));
+					return number;
+				}
+				return type() == Extracted_Value::Type::INTEGER ? static_cast<double>(as_int()) : -1;
+			}
+
+			// Returns the bool or false if the value is not a bool.
+			bool as_bool() const noexcept
+			{
+				return type() == Extracted_Value::Type::BOOL && m_slot.m_payload != 0;
+			}
+
+			// Returns the unquoted string, or an empty string if the value is not a string.
+			std::string_view as_string() const noexcept
+			{
+				if (type() != Extracted_Value::Type::STRING || !contents_fit(1))
+				{
+					return std::string_view();
+				}
+				return std::string_view(m_image + m_slot.m_payload, m_slot.m_count);
+			}
+		};
+
+		/*
+		* Writes the JSON structure as a relocatable image that can be read in place with open_image(). The image holds
+		* offsets instead of pointers, so it can be written to a file and mapped with mmap, or placed in shared memory,
+		* and used by any number of processes without being parsed. Object members are stored sorted by key so they
+		* can be found by binary search. Images are read on machines with the same byte order as the writer.
+		* @returns The image bytes.
+		*/
+		static std::string to_image(const JSON& t_main_list)
+		{
+			std::string image(k_image_header_size, '\0');
+			Image_Slot root;
+			if (const std::vector<Node::JSON_Value>* temp_array = root_array(t_main_list.main_list))
+			{
+				root = write_image_array(*temp_array, image);
+			}
+			else if (std::holds_alternative<std::vector<Node::JSON_KVP>>(t_main_list.main_list.m_kvp))
+			{
+				root = write_image_node(t_main_list.main_list, image);
+			}
+			uint64_t image_size = image.size();
+			std::memcpy(&image[0], k_image_magic, 8);
+			std::memcpy(&image[8], &k_image_byte_order, sizeof(k_image_byte_order));
+			std::memcpy(&image[12], &k_image_version, sizeof(k_image_version));
+			std::memcpy(&image[16], &image_size, sizeof(image_size));
+			std::memcpy(&image[24], &root, sizeof(root));
+			return image;
+		}
+
+		// Writes to_image() to a file. Returns false if the file cannot be written.
+		static bool write_image_file(const JSON& t_main_list, const std::string& t_file_path)
+		{
+			std::string image = to_image(t_main_list);
+			std::ofstream image_file(t_file_path, std::ios::binary | std::ios::trunc);
+			if (!image_file.is_open())
+			{
+				return false;
+			}
+			image_file.write(image.data(), static_cast<std::streamsize>(image.size()));
+			return image_file.good();
+		}
+
+		/*
+		* Opens an image written by to_image() without copying or parsing it, for example a file mapped with mmap
+		* or a shared memory segment. The memory must stay mapped while values from the image are used.
+		* @returns The root value, or a MISSING value if the memory does not hold a valid image.
+		*/
+		static Image_Value open_image(const void* t_data, const size_t t_size) noexcept
+		{
+			const char* image = static_cast<const char*>(t_data);
+			uint32_t byte_order = 0;
+			uint32_t version = 0;
+			uint64_t image_size = 0;
+			if (image == nullptr || t_size < k_image_header_size || std::memcmp(image, k_image_magic, 8) != 0)
+			{
+				return Image_Value();
+			}
+			std::memcpy(&byte_order, image + 8, sizeof(byte_order));
+			std::memcpy(&version, image + 12, sizeof(version));
+			std::memcpy(&image_size, image + 16, sizeof(image_size));
+			if (byte_order != k_image_byte_order || version != k_image_version || image_size > t_size)
+			{
+				return Image_Value();
+			}
+			Image_Slot root;
+			std::memcpy(&root, image + 24, sizeof(root));
+			return Image_Value(image, static_cast<size_t>(image_size), root);
+		}
+
+	private:
+		// Appends t_size zero bytes, rounded up to keep the next record 8 byte aligned, and returns their offset.
+		static size_t reserve_image(std::string& t_image, const size_t t_size)
+		{
+			size_t offset = t_image.size();
+			t_image.append((t_size + 7) & ~static_cast<size_t>(7), '\0');
+			return offset;
+		}
+
+		static size_t append_image_bytes(std::string& t_image, const std::string& t_bytes)
+		{
+			size_t offset = reserve_image(t_image, t_bytes.size());
+			if (!t_bytes.empty())
+			{
+				std::memcpy(&t_image[offset], t_bytes.data(), t_bytes.size());
+			}
+			return offset;
+		}
+
+		static Image_Slot make_image_slot(const Extracted_Value::Type t_type, const uint32_t t_count, const uint64_t t_payload) noexcept
+		{
+			Image_Slot temp_slot;
+			temp_slot.m_type = static_cast<uint8_t>(t_type);
+			temp_slot.m_count = t_count;
+			temp_slot.m_payload = t_payload;
+			return temp_slot;
+		}
+
+		static Image_Slot write_image_value(const Node::JSON_Value& t_value, std::string& t_image)
+		{
+			long long temp_integer = 0;
+			if (read_integer(t_value, temp_integer))
+			{
+				return make_image_slot(Extracted_Value::Type::INTEGER, 0, static_cast<uint64_t>(temp_integer));
+			}
+			if (is_number(t_value))
+			{
+				double number = number_of(t_value);
+				uint64_t bits = 0;
+				std::memcpy(&bits, &number, sizeof(bits));
+				return make_image_slot(Extracted_Value::Type::DOUBLE, 0, bits);
+			}
+			if (const bool* temp_bool = std::get_if<bool>(&t_value.m_value_individual))
+			{
+				return make_image_slot(Extracted_Value::Type::BOOL, 0, *temp_bool ? 1 : 0);
+			}
+			if (const std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual))
+			{
+				std::string text;
+				read_stored_string(*temp_string, text);
+				return make_image_slot(Extracted_Value::Type::STRING, static_cast<uint32_t>(text.size()), append_image_bytes(t_image, text));
+			}
+			if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				return write_image_node(**temp_node, t_image);
+			}
+			if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				return write_image_array(*temp_array, t_image);
+			}
+			return make_image_slot(Extracted_Value::Type::NULL_VALUE, 0, 0);
+		}
+
+		// The element slots are reserved first and filled in as each element's contents are appended after them.
+		static Image_Slot write_image_array(const std::vector<Node::JSON_Value>& t_array, std::string& t_image)
+		{
+			std::vector<const Node::JSON_Value*> elements;
+			elements.reserve(t_array.size());
+			for (const Node::JSON_Value& element : t_array)
+			{
+				if (!element.m_removed)
+				{
+					elements.push_back(&element);
+				}
+			}
+			size_t slots = reserve_image(t_image, elements.size() * sizeof(Image_Slot));
+			for (size_t i = 0; i < elements.size(); i++)
+			{
+				Image_Slot temp_slot = write_image_value(*elements[i], t_image);
+				std::memcpy(&t_image[slots + i * sizeof(Image_Slot)], &temp_slot, sizeof(temp_slot));
+			}
+			return make_image_slot(Extracted_Value::Type::ARRAY, static_cast<uint32_t>(elements.size()), slots);
+		}
+
+		static Image_Slot write_image_node(const Node& t_node, std::string& t_image)
+		{
+			std::vector<const Node::JSON_KVP*> members;
+			if (const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp))
+			{
+				members.reserve(temp_kvp_array->size());
+				for (const Node::JSON_KVP& kvp : *temp_kvp_array)
+				{
+					if (!kvp.m_removed)
+					{
+						members.push_back(&kvp);
+					}
+				}
+			}
+			std::stable_sort(members.begin(), members.end(), [](const Node::JSON_KVP* t_left, const Node::JSON_KVP* t_right) { return t_left->m_key < t_right->m_key; });
+
+			size_t entries = reserve_image(t_image, members.size() * k_image_entry_size);
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				uint64_t key_offset = append_image_bytes(t_image, members[i]->m_key);
+				uint32_t key_length = static_cast<uint32_t>(members[i]->m_key.size());
+				Image_Slot temp_slot = write_image_value(members[i]->m_value, t_image);
+				size_t entry = entries + i * k_image_entry_size;
+				std::memcpy(&t_image[entry], &key_offset, sizeof(key_offset));
+				std::memcpy(&t_image[entry + sizeof(key_offset)], &key_length, sizeof(key_length));
+				std::memcpy(&t_image[entry + 16], &temp_slot, sizeof(temp_slot));
+			}
+			return make_image_slot(Extracted_Value::Type::OBJECT, static_cast<uint32_t>(members.size()), entries);
+		}
+
+
+		//*********************************************** VALIDATE **********************************************\\
+
+	public:
+		// Containers nested deeper than this are reported as errors by validate().
+		static constexpr size_t k_max_validate_depth = 1024;
+
+		/*
+		* Checks that the input is a single JSON value following the RFC 8259 grammar strictly: strings and keys in
+		* double quotes, no control characters in strings, valid escapes and UTF-8, and numbers without leading zeros.
+		* parse() also accepts relaxed input such as single quotes and unquoted keys, which fails here. Every read is
+		* bounds checked and nothing is allocated, so this can run on untrusted buffers before they are parsed. It is
+		* constexpr, so literals can also be checked at compile time.
+		* @param t_data Start of the input. It does not need to be null terminated.
+		* @param t_size Size of the input in bytes.
+		* @returns std::string::npos if the input is valid, otherwise the offset of the first invalid byte.
+		*/
+		static constexpr size_t validate(const char* t_data, const size_t t_size) noexcept
+		{
+			const char* it = t_data;
+			const char* end = t_data + t_size;
+			uint64_t object_bits[k_max_validate_depth / 64] = {};	// bit set when the container at that depth is an object
+			size_t depth = 0;
+
+			while (true)
+			{
+				// read a value
+				skip_json_whitespace(it, end);
+				if (it < end && (*it == '{' || *it == '['))
+				{
+					const bool is_object = *it == '{';
+					if (depth == k_max_validate_depth)
+					{
+						return static_cast<size_t>(it - t_data);
+					}
+					it++;
+					skip_json_whitespace(it, end);
+					if (it < end && *it == (is_object ? '}' : ']'))
+					{
+						it++;
+					}
+					else
+					{
+						if (is_object)
+						{
+							object_bits[depth / 64] |= uint64_t(1) << (depth % 64);
+							if (!validate_member_key(it, end))
+							{
+								return static_cast<size_t>(it - t_data);
+							}
+						}
+						else
+						{
+							object_bits[depth / 64] &= ~(uint64_t(1) << (depth % 64));
+						}
+						depth++;
+						continue;
+					}
+				}
+				else if (!validate_scalar(it, end))
+				{
+					return static_cast<size_t>(it - t_data);
+				}
+
+				// close any containers that end after this value, then move to the next value
+				while (true)
+				{
+					skip_json_whitespace(it, end);
+					if (depth == 0)
+					{
+						return it == end ? std::string::npos : static_cast<size_t>(it - t_data);
+					}
+					const bool in_object = (object_bits[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1;
+					if (it < end && *it == ',')
+					{
+						it++;
+						if (in_object && !validate_member_key(it, end))
+						{
+							return static_cast<size_t>(it - t_data);
+						}
+						break;
+					}
+					if (it < end && *it == (in_object ? '}' : ']'))
+					{
+						it++;
+						depth--;
+						continue;
+					}
+					return static_cast<size_t>(it - t_data);
+				}
+			}
+		}
+
+		static size_t validate(const std::string& t_json_input) noexcept
+		{
+			return validate(t_json_input.data(), t_json_input.size());
+		}
+
+	private:
+		// The validate helpers leave t_it on the first invalid byte when they return false.
+		static constexpr void skip_json_whitespace(const char*& t_it, const char* t_end) noexcept
+		{
+			while (t_it < t_end && (*t_it == ' ' || *t_it == '\t' || *t_it == '\n' || *t_it == '\r'))
+			{
+				t_it++;
+			}
+		}
+
+		// Validates a key, the whitespace around it, and the ':' that follows.
+		static constexpr bool validate_member_key(const char*& t_it, const char* t_end) noexcept
+		{
+			skip_json_whitespace(t_it, t_end);
+			if (!validate_string(t_it, t_end))
+			{
+				return false;
+			}
+			skip_json_whitespace(t_it, t_end);
+			if (t_it >= t_end || *t_it != ':')
+			{
+				return false;
+			}
+			t_it++;
+			return true;
+		}
+
+		static constexpr bool validate_scalar(const char*& t_it, const char* t_end) noexcept
+		{
+			if (t_it >= t_end)
+			{
+				return false;
+			}
+			switch (*t_it)
+			{
+			case '"': return validate_string(t_it, t_end);
+			case 't': return validate_literal(t_it, t_end, "true", 4);
+			case 'f': return validate_literal(t_it, t_end, "false", 5);
+			case 'n': return validate_literal(t_it, t_end, "null", 4);
+			default: return validate_number(t_it, t_end);
+			}
+		}
+
+		static constexpr bool validate_literal(const char*& t_it, const char* t_end, const char* t_literal, const size_t t_length) noexcept
+		{
+			for (size_t i = 0; i < t_length; i++)
+			{
+				if (t_it >= t_end || *t_it != t_literal[i])
+				{
+					return false;
+				}
+				t_it++;
+			}
+			return true;
+		}
+
+		static constexpr bool is_digit(const char* t_it, const char* t_end) noexcept
+		{
+			return t_it < t_end && *t_it >= '0' && *t_it <= '9';
+		}
+
+		// -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+		static constexpr bool validate_number(const char*& t_it, const char* t_end) noexcept
+		{
+			if (t_it < t_end && *t_it == '-')
+			{
+				t_it++;
+			}
+			if (!is_digit(t_it, t_end))
+			{
+				return false;
+			}
+			if (*t_it++ != '0')
+			{
+				while (is_digit(t_it, t_end)) { t_it++; }
+			}
+			if (t_it < t_end && *t_it == '.')
+			{
+				t_it++;
+				if (!is_digit(t_it, t_end))
+				{
+					return false;
+				}
+				while (is_digit(t_it, t_end)) { t_it++; }
+			}
+			if (t_it < t_end && (*t_it == 'e' || *t_it == 'E'))
+			{
+				t_it++;
+				if (t_it < t_end && (*t_it == '+' || *t_it == '-'))
+				{
+					t_it++;
+				}
+				if (!is_digit(t_it, t_end))
+				{
+					return false;
+				}
+				while (is_digit(t_it, t_end)) { t_it++; }
+			}
+			return true;
+		}
+
+		// Validates a double quoted string. \u escapes must form complete surrogate pairs, as parse() requires.
+		static constexpr bool validate_string(const char*& t_it, const char* t_end) noexcept
+		{
+			if (t_it >= t_end || *t_it != '"')
+			{
+				return false;
+			}
+			t_it++;
+			while (t_it < t_end)
+			{
+				const unsigned char current = static_cast<unsigned char>(*t_it);
+				if (current == '"')
+				{
+					t_it++;
+					return true;
+				}
+				if (current == '\\')
+				{
+					if (!validate_escape(t_it, t_end))
+					{
+						return false;
+					}
+				}
+				else if (current < 0x20)
+				{
+					return false;
+				}
+				else if (current < 0x80)
+				{
+					t_it++;
+				}
+				else if (!validate_utf8(t_it, t_end))
+				{
+					return false;
+				}
+			}
+			return false;
+		}
+
+		// Reads the four hex digits after "\u". t_it is on the backslash.
+		static constexpr bool validate_hex4(const char*& t_it, const char* t_end, unsigned int& t_code_unit) noexcept
+		{
+			if (t_end - t_it < 6 || t_it[0] != '\\' || t_it[1] != 'u')
+			{
+				return false;
+			}
+			t_code_unit = 0;
+			for (int i = 2; i < 6; i++)
+			{
+				const char digit = t_it[i];
+				unsigned int value = 0;
+				if (digit >= '0' && digit <= '9') { value = digit - '0'; }
+				else if (digit >= 'a' && digit <= 'f') { value = digit - 'a' + 10; }
+				else if (digit >= 'A' && digit <= 'F') { value = digit - 'A' + 10; }
+				else { return false; }
+				t_code_unit = (t_code_unit << 4) | value;
+			}
+			t_it += 6;
+			return true;
+		}
+
+		static constexpr bool validate_escape(const char*& t_it, const char* t_end) noexcept
+		{
+			if (t_end - t_it < 2)
+			{
+				return false;
+			}
+			switch (t_it[1])
+			{
+			case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+				t_it += 2;
+				return true;
+			case 'u':
+			{
+				const char* escape_begin = t_it;
+				unsigned int code_unit = 0;
+				if (!validate_hex4(t_it, t_end, code_unit))
+				{
+					return false;
+				}
+				if (code_unit >= 0xDC00 && code_unit <= 0xDFFF)
+				{
+					t_it = escape_begin;
+					return false;
+				}
+				if (code_unit >= 0xD800 && code_unit <= 0xDBFF)
+				{
+					const char* low_begin = t_it;
+					if (!validate_hex4(t_it, t_end, code_unit) || code_unit < 0xDC00 || code_unit > 0xDFFF)
+					{
+						t_it = low_begin;
+						return false;
+					}
+				}
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		// Validates one multi-byte UTF-8 sequence, rejecting overlong forms, surrogates, and code points above U+10FFFF.
+		static constexpr bool validate_utf8(const char*& t_it, const char* t_end) noexcept
+		{
+			const unsigned char lead = static_cast<unsigned char>(*t_it);
+			size_t length = 0;
+			unsigned char second_low = 0x80;
+			unsigned char second_high = 0xBF;
+			if (lead >= 0xC2 && lead <= 0xDF) { length = 2; }
+			else if (lead >= 0xE0 && lead <= 0xEF) { length = 3; }
+			else if (lead >= 0xF0 && lead <= 0xF4) { length = 4; }
+			else { return false; }
+			if (lead == 0xE0) { second_low = 0xA0; }
+			else if (lead == 0xED) { second_high = 0x9F; }
+			else if (lead == 0xF0) { second_low = 0x90; }
+			else if (lead == 0xF4) { second_high = 0x8F; }
+
+			if (static_cast<size_t>(t_end - t_it) < length)
+			{
+				return false;
+			}
+			const unsigned char second = static_cast<unsigned char>(t_it[1]);
+			if (second < second_low || second > second_high)
+			{
+				return false;
+			}
+			for (size_t i = 2; i < length; i++)
+			{
+				if ((static_cast<unsigned char>(t_it[i]) & 0xC0) != 0x80)
+				{
+					return false;
+				}
+			}
+			t_it += length;
+			return true;
+		}
+
+
+		//************************************************ COMPACT **********************************************\\
+
+	private:
+		/*
+		* 16 byte tagged value used by Compact_Document. Scalars and strings of up to 14 bytes are stored inline.
+		* Longer strings store their offset and length in the document's string buffer, arrays and objects store
+		* the index and number of their contiguous child cells.
+		* Byte 0 is the type and byte 1 the size of an inline string, followed by the inline string in bytes 2 to 15,
+		* or by a count in bytes 4 to 7 and a payload in bytes 8 to 15.
+		*/
+		class Compact_Cell
+		{
+		private:
+			unsigned char m_bytes[16] = {};
+
+		public:
+			static constexpr size_t k_inline_capacity = 14;
+			static constexpr unsigned char k_not_inline = 0xFF;
+
+			Compact_Cell() noexcept
+			{
+				m_bytes[0] = static_cast<unsigned char>(Extracted_Value::Type::MISSING);
+			}
+
+			Compact_Cell(const Extracted_Value::Type t_type, const uint32_t t_count, const uint64_t t_payload) noexcept
+			{
+				m_bytes[0] = static_cast<unsigned char>(t_type);
+				m_bytes[1] = k_not_inline;
+				std::memcpy(m_bytes + 4, &t_count, sizeof(t_count));
+				std::memcpy(m_bytes + 8, &t_payload, sizeof(t_payload));
+			}
+
+			// Makes an inline string. t_size must not be larger than k_inline_capacity.
+			static Compact_Cell inline_string(const char* t_text, const size_t t_size) noexcept
+			{
+				Compact_Cell temp_cell;
+				temp_cell.m_bytes[0] = static_cast<unsigned char>(Extracted_Value::Type::STRING);
+				temp_cell.m_bytes[1] = static_cast<unsigned char>(t_size);
+				std::memcpy(temp_cell.m_bytes + 2, t_text, t_size);
+				return temp_cell;
+			}
+
+			Extracted_Value::Type type() const noexcept
+			{
+				return static_cast<Extracted_Value::Type>(m_bytes[0]);
+			}
+
+			bool is_inline() const noexcept
+			{
+				return m_bytes[1] != k_not_inline;
+			}
+
+			std::string_view inline_text() const noexcept
+			{
+				return std::string_view(reinterpret_cast<const char*>(m_bytes + 2), m_bytes[1]);
+			}
+
+			uint32_t count() const noexcept
+			{
+				uint32_t temp_count = 0;
+				std::memcpy(&temp_count, m_bytes + 4, sizeof(temp_count));
+				return temp_count;
+			}
+
+			uint64_t payload() const noexcept
+			{
+				uint64_t temp_payload = 0;
+				std::memcpy(&temp_payload, m_bytes + 8, sizeof(temp_payload));
+				return temp_payload;
+			}
+		};
+		static_assert(sizeof(Compact_Cell) == 16, "Compact_Cell must be 16 bytes");
+
+	public:
+		class Compact_Document;
+
+		/*
+		* Read-only view of a value in a Compact_Document. Elements of an array and members of an object are stored
+		* next to each other, so an() is an index into the cells and dn() is a scan over them. Views stay valid while
+		* the document exists and is not moved.
+		*/
+		class Compact_Value
+		{
+			friend class JSON;
+		private:
+			const Compact_Document* m_document = nullptr;
+			size_t m_index = 0;
+
+			Compact_Value(const Compact_Document* t_document, const size_t t_index) noexcept : m_document(t_document), m_index(t_index) {}
+
+			const Compact_Cell& cell() const noexcept
+			{
+				return m_document->m_cells[m_index];
+			}
+
+		public:
+			Compact_Value() = default;
+
+			Extracted_Value::Type type() const noexcept
+			{
+				return m_document == nullptr ? Extracted_Value::Type::MISSING : cell().type();
+			}
+
+			bool found() const noexcept
+			{
+				return type() != Extracted_Value::Type::MISSING;
+			}
+
+			// Returns the number of elements of an array or members of an object, or 0 otherwise.
+			size_t size() const noexcept
+			{
+				return type() == Extracted_Value::Type::ARRAY || type() == Extracted_Value::Type::OBJECT ? cell().count() : 0;
+			}
+
+			// Returns the element at t_index of an array, or the value of member t_index of an object.
+			Compact_Value an(const size_t t_index) const noexcept
+			{
+				if (t_index >= size())
+				{
+					return Compact_Value();
+				}
+				size_t first = static_cast<size_t>(cell().payload());
+				// object members are stored as a key cell followed by a value cell
+				return type() == Extracted_Value::Type::ARRAY ? Compact_Value(m_document, first + t_index) : Compact_Value(m_document, first + t_index * 2 + 1);
+			}
+
+			// Returns the key of member t_index of an object.
+			std::string_view key(const size_t t_index) const noexcept
+			{
+				if (type() != Extracted_Value::Type::OBJECT || t_index >= size())
+				{
+					return std::string_view();
+				}
+				return Compact_Value(m_document, static_cast<size_t>(cell().payload()) + t_index * 2).as_string();
+			}
+
+			// Returns the value of the first member of an object with the key t_key.
+			Compact_Value dn(const std::string_view t_key) const noexcept
+			{
+				for (size_t i = 0; i < size() && type() == Extracted_Value::Type::OBJECT; i++)
+				{
+					if (key(i) == t_key)
+					{
+						return an(i);
+					}
+				}
+				return Compact_Value();
+			}
+
+			// Returns the integer or -1 if the value is not an integer.
+			long long as_int() const noexcept
+			{
+				return type() == Extracted_Value::Type::INTEGER ? static_cast<long long>(cell().payload()) : -1;
+			}
+
+			// Returns the number or -1 if the value is not a number.
+			double as_double() const noexcept
+			{
+				if (type() == Extracted_Value::Type::DOUBLE)
+				{
+					double number = 0;
+					uint64_t bits = cell().payload();
+					std::memcpy(&number, &bits, sizeof(number));
+					return number;
+				}
+				return type() == Extracted_Value::Type::INTEGER ? static_cast<double>(as_int()) : -1;
+			}
+
+			// Returns the bool or false if the value is not a bool.
+			bool as_bool() const noexcept
+			{
+				return type() == Extracted_Value::Type::BOOL && cell().payload() != 0;
+			}
+
+			// Returns the unquoted string, or an empty string if the value is not a string.
+			std::string_view as_string() const noexcept
+			{
+				if (type() != Extracted_Value::Type::STRING)
+				{
+					return std::string_view();
+				}
+				if (cell().is_inline())
+				{
+					return cell().inline_text();
+				}
+				return std::string_view(m_document->m_strings.data() + cell().payload(), cell().count());
+			}
+		};
+
+		/*
+		* Read-only document stored as 16 byte cells instead of a tree of JSON_Value objects. Numbers, bools, and
+		* short strings are stored inline, the children of each array and object are stored contiguously, and longer
+		* strings share one buffer, so a whole document takes two allocations. Use it for large documents that are
+		* read but not edited. Build one with parse_compact().
+		*/
+		class Compact_Document
+		{
+			friend class JSON;
+			friend class Compact_Value;
+		private:
+			std::vector<Compact_Cell> m_cells;	// the root is the last cell
+			std::string m_strings;				// strings longer than Compact_Cell::k_inline_capacity
+
+		public:
+			Compact_Value root() const noexcept
+			{
+				return m_cells.empty() ? Compact_Value() : Compact_Value(this, m_cells.size() - 1);
+			}
+
+			// Returns the bytes of heap memory used by the cells and the string buffer.
+			size_t memory_usage() const noexcept
+			{
+				return m_cells.capacity() * sizeof(Compact_Cell) + (m_strings.capacity() > 15 ? m_strings.capacity() + 1 : 0);
+			}
+		};
+
+		/*
+		* Parses JSON text into a Compact_Document. Integers that fit in 64 bits are stored exactly, other numbers
+		* as doubles.
+		* @param t_json_input JSON formatted text input.
+		* @returns The document, or an empty document whose root is MISSING if the input contains a syntax error or
+		* a number outside the range of a double.
+		*/
+		static Compact_Document parse_compact(const std::string& t_json_input)
+		{
+			Compact_Document temp_document;
+			Compact_Builder builder(temp_document);
+			if (!parse_events(t_json_input, builder) || !builder.finish())
+			{
+				return Compact_Document();
+			}
+			return temp_document;
+		}
+
+	private:
+		/*
+		* Handler used by parse_compact(). The children of each open container are collected in a frame and copied to
+		* the end of the document's cells as one block when the container closes, so the children of every container
+		* are contiguous. The root is added last.
+		*/
+		class Compact_Builder : public Event_Handler
+		{
+		private:
+			struct Frame
+			{
+				std::vector<Compact_Cell> m_children;
+				bool m_is_object = false;
+			};
+
+			Compact_Document& m_document;
+			std::vector<Frame> m_stack;	// frames are reused between containers at the same depth
+			size_t m_depth = 0;
+			bool m_failed = false;		// parsing was stopped by a number that does not fit in a double
+
+		public:
+			explicit Compact_Builder(Compact_Document& t_document) : m_document(t_document) {}
+
+			bool start_object() { return open(true); }
+			bool start_array() { return open(false); }
+			bool end_object() { return close(Extracted_Value::Type::OBJECT); }
+			bool end_array() { return close(Extracted_Value::Type::ARRAY); }
+			bool key(const std::string& t_key) { return add(make_string(t_key)); }
+			bool null_value() { return add(Compact_Cell(Extracted_Value::Type::NULL_VALUE, 0, 0)); }
+			bool bool_value(const bool t_value) { return add(Compact_Cell(Extracted_Value::Type::BOOL, 0, t_value ? 1 : 0)); }
+			bool string_value(const std::string& t_value) { return add(make_string(t_value)); }
+			bool int_value(const int t_value) { return add(Compact_Cell(Extracted_Value::Type::INTEGER, 0, static_cast<uint64_t>(static_cast<long long>(t_value)))); }
+
+			bool double_value(const double t_value)
+			{
+				uint64_t bits = 0;
+				std::memcpy(&bits, &t_value, sizeof(bits));
+				return add(Compact_Cell(Extracted_Value::Type::DOUBLE, 0, bits));
+			}
+
+			bool number_text(const char* t_begin, const char* t_end)
+			{
+				long long temp_int = 0;
+				std::from_chars_result result = std::from_chars(t_begin, t_end, temp_int);
+				if (!Scanner::is_floating_point(t_begin, t_end) && result.ec == std::errc() && result.ptr == t_end)
+				{
+					return add(Compact_Cell(Extracted_Value::Type::INTEGER, 0, static_cast<uint64_t>(temp_int)));
+				}
+				double temp_double = 0;
+				result = std::from_chars(t_begin, t_end, temp_double);
+				if (result.ec != std::errc())
+				{
+					m_failed = true;
+					return false;
+				}
+				return double_value(temp_double);
+			}
+
+			// Returns false if the input held no value or parsing was stopped by a number out of range.
+			bool finish()
+			{
+				m_document.m_cells.shrink_to_fit();
+				return !m_failed && !m_document.m_cells.empty();
+			}
+
+		private:
+			Compact_Cell make_string(const std::string& t_value)
+			{
+				if (t_value.size() <= Compact_Cell::k_inline_capacity)
+				{
+					return Compact_Cell::inline_string(t_value.data(), t_value.size());
+				}
+				uint64_t offset = m_document.m_strings.size();
+				m_document.m_strings += t_value;
+				return Compact_Cell(Extracted_Value::Type::STRING, static_cast<uint32_t>(t_value.size()), offset);
+			}
+
+			bool open(const bool t_is_object)
+			{
+				if (m_depth == m_stack.size())
+				{
+					m_stack.emplace_back();
+				}
+				Frame& frame = m_stack[m_depth++];
+				frame.m_children.clear();
+				frame.m_is_object = t_is_object;
+				return true;
+			}
+
+			bool close(const Extracted_Value::Type t_type)
+			{
+				Frame& frame = m_stack[--m_depth];
+				uint64_t first = m_document.m_cells.size();
+				uint32_t count = static_cast<uint32_t>(frame.m_is_object ? frame.m_children.size() / 2 : frame.m_children.size());
+				m_document.m_cells.insert(m_document.m_cells.end(), frame.m_children.begin(), frame.m_children.end());
+				return add(Compact_Cell(t_type, count, first));
+			}
+
+			bool add(const Compact_Cell& t_cell)
+			{
+				if (m_depth == 0)
+				{
+					m_document.m_cells.push_back(t_cell);
+					return true;
+				}
+				m_stack[m_depth - 1].m_children.push_back(t_cell);
+				return true;
+			}
+		};
+
+
+		//************************************************* REUSE ***********************************************\\
+
+	public:
+		/*
+		* Parser that keeps its working buffers between calls. Parsing into an existing JSON object also reuses the
+		* vectors, strings and nodes of the document it held before, so a loop that parses messages of a similar shape
+		* allocates almost nothing once the buffers have grown. Use one Parser per thread.
+		*/
+		class Parser
+		{
+		private:
+			Scan_Buffers m_buffers;
+			Document_Builder m_builder;
+
+		public:
+			/**
+			* Replaces the contents of t_output with the parsed input. The key index and serialize cache settings of
+			* t_output are kept.
+			* @param t_json_input JSON formatted text input.
+			* @param t_output Document to fill. Its previous contents are recycled as if by clear().
+			* @returns false if the input contains a syntax error, in which case t_output is left empty.
+			*/
+			bool parse(const std::string& t_json_input, JSON& t_output)
+			{
+				t_output.clear();
+				m_builder.reset(t_output.main_list, t_output.m_storage.get());
+				Scanner scanner(t_json_input.data(), t_json_input.data() + t_json_input.size());
+				if (!scan_events(scanner, m_builder, m_buffers))
+				{
+					t_output.clear();
+					return false;
+				}
+				if (t_output.m_key_index != nullptr)
+				{
+					t_output.enable_key_index();
+				}
+				return true;
+			}
+
+			/**
+			* Parses string input into a new JSON object using the buffers of this parser.
+			* @returns A JSON object, or an empty JSON object if the input contains a syntax error.
+			*/
+			JSON parse(const std::string& t_json_input)
+			{
+				JSON temp_list;
+				parse(t_json_input, temp_list);
+				return temp_list;
+			}
+		};
+
+		/*
+		* Removes every key and value. The document's vectors, strings and nodes are kept with their capacity and are
+		* reused the next time a Parser parses into this object. References to values in the document are invalidated.
+		*/
+		void clear()
+		{
+			if (m_storage == nullptr)
+			{
+				m_storage.reset(new Storage_Pool);
+			}
+			recycle_node(main_list, *m_storage);
+			main_list.m_defer_removals = false;
+			if (m_key_index != nullptr)
+			{
+				enable_key_index();
+			}
+		}
+
+	private:
+		// Emptied containers and strings taken from cleared documents.
+		class Storage_Pool
+		{
+		public:
+			std::vector<std::shared_ptr<Node>> m_nodes;
+			std::vector<std::vector<Node::JSON_KVP>> m_members;
+			std::vector<std::vector<Node::JSON_Value>> m_elements;
+			std::vector<std::string> m_strings;
+
+			// Returns the most recently recycled entry of t_pool, or a new one if the pool is empty.
+			template<typename T>
+			static T take(std::vector<T>& t_pool)
+			{
+				if (t_pool.empty())
+				{
+					return T();
+				}
+				T temp_entry = std::move(t_pool.back());
+				t_pool.pop_back();
+				return temp_entry;
+			}
+		};
+
+		// Moves the contents of t_node into t_pool and leaves it empty. Settings held by the root are not changed.
+		static void recycle_node(Node& t_node, Storage_Pool& t_pool)
+		{
+			if (std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node.m_kvp))
+			{
+				for (Node::JSON_KVP& kvp : *temp_kvp_array)
+				{
+					recycle_string(kvp.m_key, t_pool);
+					recycle_value(kvp.m_value, t_pool);
+				}
+				temp_kvp_array->clear();
+				t_pool.m_members.push_back(std::move(*temp_kvp_array));
+			}
+			t_node.m_kvp = std::monostate();
+			t_node.m_object_key.clear();
+			t_node.m_serialized_valid = false;
+			t_node.m_serialized.clear();
+			t_node.m_hash.reset();
+		}
+
+		static void recycle_value(Node::JSON_Value& t_value, Storage_Pool& t_pool)
+		{
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				// a node still shared with the caller is left to its other owner
+				if (temp_node->use_count() == 1)
+				{
+					recycle_node(**temp_node, t_pool);
+					(*temp_node)->m_parent = nullptr;
+					t_pool.m_nodes.push_back(std::move(*temp_node));
+				}
+			}
+			else if (std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				for (Node::JSON_Value& element : *temp_array)
+				{
+					recycle_value(element, t_pool);
+				}
+				temp_array->clear();
+				t_pool.m_elements.push_back(std::move(*temp_array));
+			}
+			else if (std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual))
+			{
+				recycle_string(*temp_string, t_pool);
+			}
+			else if (Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual))
+			{
+				recycle_string(temp_number->m_text, t_pool);
+			}
+		}
+
+		// Only strings with heap storage are worth keeping.
+		static void recycle_string(std::string& t_string, Storage_Pool& t_pool)
+		{
+			if (t_string.capacity() > std::string().capacity())
+			{
+				t_string.clear();
+				t_pool.m_strings.push_back(std::move(t_string));
+			}
+		}
+
+
+		//************************************************ STREAM ***********************************************\\
+
+	public:
+		/*
+		* Reads the elements of a top-level JSON array one at a time, for files too large to load with read_file().
+		* Input is read in chunks and only the text of the current element is kept, so memory use is proportional to
+		* the largest element rather than to the file. Elements are parsed with a Parser and reuse its storage.
+		* Input after the closing bracket of the array is not read.
+		*
+		*	JSON::Array_Reader reader("export.json");
+		*	for (JSON& element : reader) { ... }
+		*	if (reader.failed()) { ... }
+		*/
+		class Array_Reader
+		{
+		public:
+			static constexpr size_t k_default_chunk_size = 64 * 1024;
+
+			// Input iterator over the remaining elements. Every position refers to the same element object.
+			class iterator
+			{
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = JSON;
+				using difference_type = std::ptrdiff_t;
+				using pointer = JSON*;
+				using reference = JSON&;
+
+			private:
+				Array_Reader* m_reader = nullptr;	// nullptr once the array is exhausted
+
+			public:
+				iterator() = default;
+				explicit iterator(Array_Reader* t_reader) : m_reader(t_reader)
+				{
+					advance();
+				}
+
+				JSON& operator*() const { return *m_reader->m_element; }
+				JSON* operator->() const { return m_reader->m_element.get(); }
+				iterator& operator++() { advance(); return *this; }
+				bool operator==(const iterator& t_other) const { return m_reader == t_other.m_reader; }
+				bool operator!=(const iterator& t_other) const { return m_reader != t_other.m_reader; }
+
+			private:
+				void advance()
+				{
+					if (m_reader != nullptr && !m_reader->next(*m_reader->m_element))
+					{
+						m_reader = nullptr;
+					}
+				}
+			};
+
+		private:
+			std::ifstream m_file;
+			std::istream* m_input;
+			size_t m_chunk_size;
+			std::string m_buffer;		// unread input starts at m_position
+			size_t m_position = 0;
+			std::string m_element_text;
+			Parser m_parser;
+			std::unique_ptr<JSON> m_element;	// element returned by the iterator
+			bool m_started = false;
+			bool m_done = false;
+			bool m_failed = false;
+
+		public:
+			Array_Reader(const std::string& t_file_path, const size_t t_chunk_size = k_default_chunk_size)
+				: m_file(t_file_path, std::ios::binary), m_input(&m_file), m_chunk_size(t_chunk_size == 0 ? 1 : t_chunk_size), m_element(new JSON)
+			{
+				if (!m_file.is_open())
+				{
+					m_done = true;
+					m_failed = true;
+				}
+			}
+
+			Array_Reader(std::istream& t_input, const size_t t_chunk_size = k_default_chunk_size)
+				: m_input(&t_input), m_chunk_size(t_chunk_size == 0 ? 1 : t_chunk_size), m_element(new JSON) {}
+
+			/**
+			* Parses the next element of the array into t_element, replacing its contents.
+			* @returns false at the end of the array or on an error. failed() tells the two apart.
+			*/
+			bool next(JSON& t_element)
+			{
+				if (m_done)
+				{
+					return false;
+				}
+				char token = '\0';
+				if (!next_token(token))
+				{
+					return stop(true);
+				}
+				if (!m_started)
+				{
+					if (token != '[')
+					{
+						return stop(true);
+					}
+					m_started = true;
+					m_position++;
+					if (!next_token(token))
+					{
+						return stop(true);
+					}
+					if (token == ']')
+					{
+						m_position++;
+						return stop(false);
+					}
+				}
+				else
+				{
+					if (token == ']')
+					{
+						m_position++;
+						return stop(false);
+					}
+					// elements are separated by commas, and a comma must be followed by an element
+					if (token != ',')
+					{
+						return stop(true);
+					}
+					m_position++;
+					if (!next_token(token) || token == ']')
+					{
+						return stop(true);
+					}
+				}
+				size_t element_end = 0;
+				if (!find_element_end(element_end))
+				{
+					return stop(true);
+				}
+				m_element_text.assign(m_buffer, m_position, element_end - m_position);
+				m_position = element_end;
+				if (!m_parser.parse(m_element_text, t_element))
+				{
+					return stop(true);
+				}
+				return true;
+			}
+
+			// True if the input could not be opened or read, or is not a well formed array.
+			bool failed() const noexcept
+			{
+				return m_failed;
+			}
+
+			iterator begin() { return iterator(this); }
+			iterator end() { return iterator(); }
+
+		private:
+			bool stop(const bool t_failed)
+			{
+				m_done = true;
+				m_failed = t_failed;
+				return false;
+			}
+
+			// Drops the consumed input and appends the next chunk. Returns false when no more input is available.
+			bool fill()
+			{
+				m_buffer.erase(0, m_position);
+				m_position = 0;
+				size_t old_size = m_buffer.size();
+				m_buffer.resize(old_size + m_chunk_size);
+				m_input->read(&m_buffer[old_size], static_cast<std::streamsize>(m_chunk_size));
+				size_t read_size = static_cast<size_t>(m_input->gcount());
+				m_buffer.resize(old_size + read_size);
+				return read_size > 0;
+			}
+
+			// Skips whitespace and sets t_token to the next character without consuming it.
+			bool next_token(char& t_token)
+			{
+				while (true)
+				{
+					while (m_position < m_buffer.size() && is_whitespace(m_buffer[m_position]))
+					{
+						m_position++;
+					}
+					if (m_position < m_buffer.size())
+					{
+						t_token = m_buffer[m_position];
+						return true;
+					}
+					if (!fill())
+					{
+						return false;
+					}
+				}
+			}
+
+			/*
+			* Finds the end of the element that starts at m_position by bracket and quote matching, reading more input
+			* as needed. The element is only checked for balance here, its syntax is checked when it is parsed.
+			*/
+			bool find_element_end(size_t& t_end)
+			{
+				size_t i = m_position;
+				int depth = 0;
+				char quote = '\0';
+				bool escaped = false;
+				while (true)
+				{
+					if (i == m_buffer.size())
+					{
+						size_t scanned = i - m_position;
+						if (!fill())
+						{
+							return false;
+						}
+						i = m_position + scanned;
+					}
+					char current = m_buffer[i];
+					if (quote != '\0')
+					{
+						if (escaped)
+						{
+							escaped = false;
+						}
+						else if (current == '\\')
+						{
+							escaped = true;
+						}
+						else if (current == quote)
+						{
+							quote = '\0';
+							if (depth == 0)
+							{
+								t_end = i + 1;
+								return true;
+							}
+						}
+					}
+					else if (current == '"' || current == '\'')
+					{
+						quote = current;
+					}
+					else if (current == '{' || current == '[')
+					{
+						depth++;
+					}
+					else if (current == '}' || current == ']')
+					{
+						if (depth == 0)
+						{
+							// the end of the outer array after a number or literal
+							t_end = i;
+							return i > m_position;
+						}
+						if (--depth == 0)
+						{
+							t_end = i + 1;
+							return true;
+						}
+					}
+					else if (depth == 0 && (current == ',' || is_whitespace(current)))
+					{
+						t_end = i;
+						return i > m_position;
+					}
+					i++;
+				}
+			}
+
+			static bool is_whitespace(const char t_char) noexcept
+			{
+				return t_char == ' ' || t_char == '\t' || t_char == '\n' || t_char == '\r';
+			}
+		};
+
+
+		//************************************************ STATIC ***********************************************\\
+
+	public:
+		/*
+		* Cell of a Static_Document. Strings and numbers store the length and offset of their text in the document's
+		* characters, bools store their value in m_count, and arrays and objects store the number and index of their
+		* contiguous child cells. Numbers are kept as text and converted when they are read.
+		*/
+		struct Static_Cell
+		{
+			Extracted_Value::Type m_type = Extracted_Value::Type::MISSING;
+			uint32_t m_count = 0;
+			size_t m_offset = 0;
+		};
+
+		/*
+		* Read-only view of a value in a Static_Document. Every method is constexpr and nothing is allocated, so
+		* lookups on a constexpr document can be done at compile time. Views stay valid while the document exists.
+		*/
+		class Static_Value
+		{
+			friend class JSON;
+		private:
+			const Static_Cell* m_cells = nullptr;
+			const char* m_chars = nullptr;
+			size_t m_index = 0;
+
+			constexpr Static_Value(const Static_Cell* t_cells, const char* t_chars, const size_t t_index) noexcept : m_cells(t_cells), m_chars(t_chars), m_index(t_index) {}
+
+			constexpr const Static_Cell& cell() const noexcept
+			{
+				return m_cells[m_index];
+			}
+
+			constexpr std::string_view text() const noexcept
+			{
+				return std::string_view(m_chars + cell().m_offset, cell().m_count);
+			}
+
+		public:
+			constexpr Static_Value() = default;
+
+			constexpr Extracted_Value::Type type() const noexcept
+			{
+				return m_cells == nullptr ? Extracted_Value::Type::MISSING : cell().m_type;
+			}
+
+			constexpr bool found() const noexcept
+			{
+				return type() != Extracted_Value::Type::MISSING;
+			}
+
+			// Returns the number of elements of an array or members of an object, or 0 otherwise.
+			constexpr size_t size() const noexcept
+			{
+				return type() == Extracted_Value::Type::ARRAY || type() == Extracted_Value::Type::OBJECT ? cell().m_count : 0;
+			}
+
+			// Returns the element at t_index of an array, or the value of member t_index of an object.
+			constexpr Static_Value an(const size_t t_index) const noexcept
+			{
+				if (t_index >= size())
+				{
+					return Static_Value();
+				}
+				// object members are stored as a key cell followed by a value cell
+				size_t first = cell().m_offset;
+				return Static_Value(m_cells, m_chars, type() == Extracted_Value::Type::ARRAY ? first + t_index : first + t_index * 2 + 1);
+			}
+
+			// Returns the key of member t_index of an object.
+			constexpr std::string_view key(const size_t t_index) const noexcept
+			{
+				if (type() != Extracted_Value::Type::OBJECT || t_index >= size())
+				{
+					return std::string_view();
+				}
+				return Static_Value(m_cells, m_chars, cell().m_offset + t_index * 2).as_string();
+			}
+
+			// Returns the value of the first member of an object with the key t_key.
+			constexpr Static_Value dn(const std::string_view t_key) const noexcept
+			{
+				for (size_t i = 0; i < size() && type() == Extracted_Value::Type::OBJECT; i++)
+				{
+					if (key(i) == t_key)
+					{
+						return an(i);
+					}
+				}
+				return Static_Value();
+			}
+
+			// Returns the integer or -1 if the value is not an integer.
+			constexpr long long as_int() const noexcept
+			{
+				long long temp_int = -1;
+				if (type() != Extracted_Value::Type::INTEGER || !read_static_integer(text().data(), text().data() + text().size(), temp_int))
+				{
+					return -1;
+				}
+				return temp_int;
+			}
+
+			// Returns the number or -1 if the value is not a number. Numbers with a fraction or exponent are converted
+			// at run time.
+			constexpr double as_double() const noexcept
+			{
+				if (type() == Extracted_Value::Type::INTEGER)
+				{
+					return static_cast<double>(as_int());
+				}
+				if (type() != Extracted_Value::Type::DOUBLE)
+				{
+					return -1;
+				}
+				double number = 0;
+				std::from_chars(text().data(), text().data() + text().size(), number);
+				return number;
+			}
+
+			// Returns the bool or false if the value is not a bool.
+			constexpr bool as_bool() const noexcept
+			{
+				return type() == Extracted_Value::Type::BOOL && cell().m_count != 0;
+			}
+
+			// Returns the unquoted string, or an empty string if the value is not a string.
+			constexpr std::string_view as_string() const noexcept
+			{
+				return type() == Extracted_Value::Type::STRING ? text() : std::string_view();
+			}
+		};
+
+	private:
+		/*
+		* Builds the cells of a Static_Document in the same order as Compact_Builder: the children of each open
+		* container wait in m_pending and are copied to the cells as one block when it closes, and the root is added
+		* last. Without storage it only counts the cells and characters a document needs.
+		*/
+		class Static_Builder
+		{
+		public:
+			Static_Cell* m_cells = nullptr;		// nullptr when only counting
+			size_t m_cell_capacity = 0;
+			char* m_chars = nullptr;
+			size_t m_char_capacity = 0;
+			Static_Cell* m_pending = nullptr;	// same capacity as m_cells
+			size_t* m_frames = nullptr;			// index in m_pending of the first child of each open container
+			size_t m_cell_count = 0;
+			size_t m_char_count = 0;
+			size_t m_pending_count = 0;
+			bool m_overflow = false;
+
+			constexpr Static_Builder() = default;
+			constexpr Static_Builder(Static_Cell* t_cells, const size_t t_cell_capacity, char* t_chars, const size_t t_char_capacity, Static_Cell* t_pending, size_t* t_frames) noexcept
+				: m_cells(t_cells), m_cell_capacity(t_cell_capacity), m_chars(t_chars), m_char_capacity(t_char_capacity), m_pending(t_pending), m_frames(t_frames) {}
+
+			// Returns false if the input is not strict JSON or does not fit in the storage.
+			constexpr bool build(const std::string_view t_json_input) noexcept
+			{
+				const char* it = t_json_input.data();
+				const char* end = it + t_json_input.size();
+				if (validate(it, t_json_input.size()) != std::string::npos)
+				{
+					return false;
+				}
+				// the input is valid from here on, so it is walked without further checks
+				uint64_t object_bits[k_max_validate_depth / 64] = {};
+				size_t depth = 0;
+				while (true)
+				{
+					skip_json_whitespace(it, end);
+					if (*it == '{' || *it == '[')
+					{
+						const bool is_object = *it == '{';
+						it++;
+						skip_json_whitespace(it, end);
+						if (*it != (is_object ? '}' : ']'))
+						{
+							open(depth);
+							if (is_object)
+							{
+								object_bits[depth / 64] |= uint64_t(1) << (depth % 64);
+								add_key(it, end);
+							}
+							else
+							{
+								object_bits[depth / 64] &= ~(uint64_t(1) << (depth % 64));
+							}
+							depth++;
+							continue;
+						}
+						it++;
+						add(Static_Cell{ is_object ? Extracted_Value::Type::OBJECT : Extracted_Value::Type::ARRAY, 0, 0 });
+					}
+					else
+					{
+						add_scalar(it, end);
+					}
+
+					// close any containers that end after this value, then move to the next value
+					while (true)
+					{
+						skip_json_whitespace(it, end);
+						if (depth == 0)
+						{
+							finish();
+							return !m_overflow;
+						}
+						const bool in_object = (object_bits[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1;
+						if (*it++ == ',')
+						{
+							if (in_object)
+							{
+								add_key(it, end);
+							}
+							break;
+						}
+						close(--depth, in_object);
+					}
+				}
+			}
+
+		private:
+			constexpr bool counting() const noexcept
+			{
+				return m_cells == nullptr;
+			}
+
+			constexpr void add(const Static_Cell& t_cell) noexcept
+			{
+				if (counting())
+				{
+					m_cell_count++;
+				}
+				else if (m_pending_count < m_cell_capacity)
+				{
+					m_pending[m_pending_count++] = t_cell;
+				}
+				else
+				{
+					m_overflow = true;
+				}
+			}
+
+			constexpr void put_char(const char t_char) noexcept
+			{
+				if (counting())
+				{
+					m_char_count++;
+				}
+				else if (m_char_count < m_char_capacity)
+				{
+					m_chars[m_char_count++] = t_char;
+				}
+				else
+				{
+					m_overflow = true;
+				}
+			}
+
+			constexpr void open(const size_t t_depth) noexcept
+			{
+				if (counting())
+				{
+					return;
+				}
+				if (t_depth < m_cell_capacity)
+				{
+					m_frames[t_depth] = m_pending_count;
+				}
+				else
+				{
+					m_overflow = true;
+				}
+			}
+
+			constexpr void close(const size_t t_depth, const bool t_is_object) noexcept
+			{
+				if (counting())
+				{
+					m_cell_count++;
+					return;
+				}
+				if (m_overflow)
+				{
+					return;
+				}
+				size_t first_child = m_frames[t_depth];
+				size_t children = m_pending_count - first_child;
+				size_t first = m_cell_count;
+				for (size_t i = first_child; i < m_pending_count; i++)
+				{
+					store(m_pending[i]);
+				}
+				m_pending_count = first_child;
+				add(Static_Cell{ t_is_object ? Extracted_Value::Type::OBJECT : Extracted_Value::Type::ARRAY, static_cast<uint32_t>(t_is_object ? children / 2 : children), first });
+			}
+
+			constexpr void finish() noexcept
+			{
+				if (!counting() && m_pending_count == 1)
+				{
+					store(m_pending[0]);
+				}
+			}
+
+			constexpr void store(const Static_Cell& t_cell) noexcept
+			{
+				if (m_cell_count < m_cell_capacity)
+				{
+					m_cells[m_cell_count++] = t_cell;
+				}
+				else
+				{
+					m_overflow = true;
+				}
+			}
+
+			// Adds the key at t_it and skips the ':' that follows.
+			constexpr void add_key(const char*& t_it, const char* t_end) noexcept
+			{
+				skip_json_whitespace(t_it, t_end);
+				add_string(t_it, t_end);
+				skip_json_whitespace(t_it, t_end);
+				t_it++;
+			}
+
+			constexpr void add_scalar(const char*& t_it, const char* t_end) noexcept
+			{
+				switch (*t_it)
+				{
+				case '"':
+					add_string(t_it, t_end);
+					return;
+				case 't':
+					t_it += 4;
+					add(Static_Cell{ Extracted_Value::Type::BOOL, 1, 0 });
+					return;
+				case 'f':
+					t_it += 5;
+					add(Static_Cell{ Extracted_Value::Type::BOOL, 0, 0 });
+					return;
+				case 'n':
+					t_it += 4;
+					add(Static_Cell{ Extracted_Value::Type::NULL_VALUE, 0, 0 });
+					return;
+				default:
+					break;
+				}
+				const char* number_begin = t_it;
+				validate_number(t_it, t_end);
+				size_t offset = m_char_count;
+				for (const char* number_it = number_begin; number_it < t_it; number_it++)
+				{
+					put_char(*number_it);
+				}
+				long long temp_int = 0;
+				Extracted_Value::Type type = read_static_integer(number_begin, t_it, temp_int) ? Extracted_Value::Type::INTEGER : Extracted_Value::Type::DOUBLE;
+				add(Static_Cell{ type, static_cast<uint32_t>(t_it - number_begin), offset });
+			}
+
+			// Decodes the string at t_it into the document's characters.
+			constexpr void add_string(const char*& t_it, const char* t_end) noexcept
+			{
+				size_t offset = m_char_count;
+				t_it++;
+				while (*t_it != '"')
+				{
+					if (*t_it != '\\')
+					{
+						put_char(*t_it++);
+						continue;
+					}
+					char escaped = t_it[1];
+					switch (escaped)
+					{
+					case 'b': put_char('\b'); break;
+					case 'f': put_char('\f'); break;
+					case 'n': put_char('\n'); break;
+					case 'r': put_char('\r'); break;
+					case 't': put_char('\t'); break;
+					case 'u': break;
+					default: put_char(escaped); break;
+					}
+					if (escaped != 'u')
+					{
+						t_it += 2;
+						continue;
+					}
+					unsigned int code_unit = 0;
+					validate_hex4(t_it, t_end, code_unit);
+					uint32_t code_point = code_unit;
+					if (code_unit >= 0xD800 && code_unit <= 0xDBFF)
+					{
+						validate_hex4(t_it, t_end, code_unit);
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (code_unit - 0xDC00);
+					}
+					put_utf8(code_point);
+				}
+				t_it++;
+				add(Static_Cell{ Extracted_Value::Type::STRING, static_cast<uint32_t>(m_char_count - offset), offset });
+			}
+
+			constexpr void put_utf8(const uint32_t t_code_point) noexcept
+			{
+				if (t_code_point < 0x80)
+				{
+					put_char(static_cast<char>(t_code_point));
+				}
+				else if (t_code_point < 0x800)
+				{
+					put_char(static_cast<char>(0xC0 | (t_code_point >> 6)));
+					put_char(static_cast<char>(0x80 | (t_code_point & 0x3F)));
+				}
+				else if (t_code_point < 0x10000)
+				{
+					put_char(static_cast<char>(0xE0 | (t_code_point >> 12)));
+					put_char(static_cast<char>(0x80 | ((t_code_point >> 6) & 0x3F)));
+					put_char(static_cast<char>(0x80 | (t_code_point & 0x3F)));
+				}
+				else
+				{
+					put_char(static_cast<char>(0xF0 | (t_code_point >> 18)));
+					put_char(static_cast<char>(0x80 | ((t_code_point >> 12) & 0x3F)));
+					put_char(static_cast<char>(0x80 | ((t_code_point >> 6) & 0x3F)));
+					put_char(static_cast<char>(0x80 | (t_code_point & 0x3F)));
+				}
+			}
+		};
+
+		// Reads an integer that fits in a long long. Returns false for fractions, exponents, and out of range values.
+		static constexpr bool read_static_integer(const char* t_begin, const char* t_end, long long& t_output) noexcept
+		{
+			const bool negative = t_begin < t_end && *t_begin == '-';
+			const char* it = negative ? t_begin + 1 : t_begin;
+			if (it == t_end)
+			{
+				return false;
+			}
+			// accumulate as a negative number so LLONG_MIN can be represented
+			long long value = 0;
+			for (; it < t_end; it++)
+			{
+				if (*it < '0' || *it > '9')
+				{
+					return false;
+				}
+				const int digit = *it - '0';
+				if (value < (LLONG_MIN + digit) / 10)
+				{
+					return false;
+				}
+				value = value * 10 - digit;
+			}
+			if (!negative && value == LLONG_MIN)
+			{
+				return false;
+			}
+			t_output = negative ? value : -value;
+			return true;
+		}
+
+		// Not constexpr, so reaching it while a Static_Document is built at compile time stops compilation.
+		static void static_document_error() noexcept {}
+
+	public:
+		/*
+		* Read-only document parsed from a string literal at compile time and stored in the program's constant data.
+		* The input must be strict JSON as accepted by validate(). Size the document with static_cell_count() and
+		* static_char_count() of the same literal. Declared constexpr, a malformed literal or a capacity that is too
+		* small is a compile error; built at run time, the root is MISSING instead.
+		*
+		*	static constexpr std::string_view k_defaults = R"({"port": 8080, "hosts": ["a", "b"]})";
+		*	static constexpr JSON::Static_Document<JSON::static_cell_count(k_defaults), JSON::static_char_count(k_defaults)> defaults(k_defaults);
+		*	static_assert(defaults.root().dn("port").as_int() == 8080);
+		*/
+		template<size_t t_cell_capacity, size_t t_char_capacity>
+		class Static_Document
+		{
+		private:
+			Static_Cell m_cells[t_cell_capacity + 1] = {};	// one spare entry so empty documents are valid arrays
+			char m_chars[t_char_capacity + 1] = {};
+			size_t m_cell_count = 0;	// the root is the last cell
+
+		public:
+			constexpr explicit Static_Document(const std::string_view t_json_input) noexcept
+			{
+				Static_Cell pending[t_cell_capacity + 1] = {};
+				size_t frames[t_cell_capacity + 1] = {};
+				Static_Builder builder(m_cells, t_cell_capacity, m_chars, t_char_capacity, pending, frames);
+				if (!builder.build(t_json_input))
+				{
+					static_document_error();
+					return;
+				}
+				m_cell_count = builder.m_cell_count;
+			}
+
+			constexpr Static_Value root() const noexcept
+			{
+				return m_cell_count == 0 ? Static_Value() : Static_Value(m_cells, m_chars, m_cell_count - 1);
+			}
+		};
+
+		// Returns the number of cells a Static_Document needs for t_json_input, or 0 if it is not strict JSON.
+		static constexpr size_t static_cell_count(const std::string_view t_json_input) noexcept
+		{
+			Static_Builder builder;
+			return builder.build(t_json_input) ? builder.m_cell_count : 0;
+		}
+
+		// Returns the number of characters of decoded strings and numbers a Static_Document needs for t_json_input.
+		static constexpr size_t static_char_count(const std::string_view t_json_input) noexcept
+		{
+			Static_Builder builder;
+			return builder.build(t_json_input) ? builder.m_char_count : 0;
+		}
+
+
+		//************************************************* PATH ************************************************\\
+
+	public:
+		/*
+		* JSONPath query compiled into a list of steps that query() runs over a document. Supported syntax:
+		*	$					the document root, every query starts with it
+		*	.name ['name']		member of an object
+		*	.* [*]				every member of an object or element of an array
+		*	..name ..* ..[0]	recursive descent, applies the selector to the value and every value below it
+		*	[2] [-1]			array element, negative indices count from the end
+		*	[1:5] [::2] [::-1]	array slice with optional start, end, and step
+		*	[0,2] ['a','b']		several selectors, results are in selector order
+		*	[?(@.qty > 0)]		members or elements for which a filter holds
+		* A filter condition compares a relative path such as @.a.b or @['a'][0] with a number, a string, true, false,
+		* or null using == != < <= > >=, or on its own tests that the path exists. Conditions can be negated with !
+		* and combined with && and ||, where && binds tighter. Parentheses may only enclose the whole filter.
+		* A path that fails to compile is invalid and matches nothing.
+		*/
+		class Path
+		{
+			friend class JSON;
+		private:
+			enum class Selector_Kind { NAME, WILDCARD, INDEX, SLICE, FILTER };
+			enum class Compare { EXISTS, EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL };
+
+			struct Selector
+			{
+				Selector_Kind m_kind = Selector_Kind::NAME;
+				std::string m_name;
+				long long m_index = 0;	// index, or slice start
+				long long m_end = 0;
+				long long m_step = 1;
+				bool m_has_start = false;
+				bool m_has_end = false;
+				size_t m_filter = 0;	// index in m_filters
+			};
+
+			struct Step
+			{
+				bool m_recursive = false;
+				std::vector<Selector> m_selectors;
+			};
+
+			// Member name or array index in the relative path of a filter condition.
+			struct Filter_Token
+			{
+				std::string m_name;
+				long long m_index = 0;
+				bool m_is_index = false;
+			};
+
+			struct Condition
+			{
+				std::vector<Filter_Token> m_path;
+				Compare m_compare = Compare::EXISTS;
+				bool m_negate = false;
+				Node::JSON_Value m_literal;	// strings are stored quoted and escaped, the same as parsed values
+				std::string m_text;			// unescaped string literal, used to order strings
+			};
+
+			// Conditions are joined with && inside a group and the groups are joined with ||.
+			struct Filter
+			{
+				std::vector<std::vector<Condition>> m_groups;
+			};
+
+			std::vector<Step> m_steps;
+			std::vector<Filter> m_filters;
+			bool m_valid = false;
+
+		public:
+			Path() = default;
+
+			explicit Path(const std::string& t_path)
+			{
+				m_valid = compile(t_path);
+				if (!m_valid)
+				{
+					m_steps.clear();
+					m_filters.clear();
+				}
+			}
+
+			bool valid() const noexcept
+			{
+				return m_valid;
+			}
+
+		private:
+			bool compile(const std::string& t_path)
+			{
+				size_t position = 0;
+				skip_spaces(t_path, position);
+				if (position >= t_path.size() || t_path[position] != '$')
+				{
+					return false;
+				}
+				position++;
+				while (true)
+				{
+					skip_spaces(t_path, position);
+					if (position >= t_path.size())
+					{
+						return true;
+					}
+					Step step;
+					if (t_path[position] == '.')
+					{
+						position++;
+						if (position < t_path.size() && t_path[position] == '.')
+						{
+							step.m_recursive = true;
+							position++;
+						}
+						if (position < t_path.size() && t_path[position] == '[')
+						{
+							if (!step.m_recursive || !read_brackets(t_path, position, step))
+							{
+								return false;
+							}
+						}
+						else if (!read_dot_selector(t_path, position, step))
+						{
+							return false;
+						}
+					}
+					else if (t_path[position] != '[' || !read_brackets(t_path, position, step))
+					{
+						return false;
+					}
+					m_steps.push_back(std::move(step));
+				}
+			}
+
+			static void skip_spaces(const std::string& t_path, size_t& t_position) noexcept
+			{
+				while (t_position < t_path.size() && (t_path[t_position] == ' ' || t_path[t_position] == '\t'))
+				{
+					t_position++;
+				}
+			}
+
+			// Consumes t_token if the path continues with it.
+			static bool consume(const std::string& t_path, size_t& t_position, const char* t_token) noexcept
+			{
+				size_t length = std::char_traits<char>::length(t_token);
+				if (t_path.compare(t_position, length, t_token) != 0)
+				{
+					return false;
+				}
+				t_position += length;
+				return true;
+			}
+
+			static bool is_name_char(const char t_char) noexcept
+			{
+				return (t_char >= 'a' && t_char <= 'z') || (t_char >= 'A' && t_char <= 'Z') || (t_char >= '0' && t_char <= '9') || t_char == '_' || t_char == '-'
+					|| static_cast<unsigned char>(t_char) >= 0x80;
+			}
+
+			// Reads a name after a dot. Names run until the next '.', '[', space, or the end.
+			static bool read_name(const std::string& t_path, size_t& t_position, std::string& t_name)
+			{
+				size_t begin = t_position;
+				while (t_position < t_path.size() && is_name_char(t_path[t_position]))
+				{
+					t_position++;
+				}
+				t_name.assign(t_path, begin, t_position - begin);
+				return !t_name.empty();
+			}
+
+			static bool read_dot_selector(const std::string& t_path, size_t& t_position, Step& t_step)
+			{
+				Selector selector;
+				if (consume(t_path, t_position, "*"))
+				{
+					selector.m_kind = Selector_Kind::WILDCARD;
+				}
+				else if (!read_name(t_path, t_position, selector.m_name))
+				{
+					return false;
+				}
+				t_step.m_selectors.push_back(std::move(selector));
+				return true;
+			}
+
+			// Reads a quoted name with the same quoting and escapes as parse().
+			static bool read_quoted(const std::string& t_path, size_t& t_position, std::string& t_output)
+			{
+				Scanner scanner(t_path.data() + t_position, t_path.data() + t_path.size());
+				if (!scanner.read_string(t_output))
+				{
+					return false;
+				}
+				t_position += scanner.offset();
+				return true;
+			}
+
+			static bool read_integer(const std::string& t_path, size_t& t_position, long long& t_output)
+			{
+				const char* begin = t_path.data() + t_position;
+				const char* end = t_path.data() + t_path.size();
+				std::from_chars_result result = std::from_chars(begin, end, t_output);
+				if (result.ec != std::errc())
+				{
+					return false;
+				}
+				t_position += static_cast<size_t>(result.ptr - begin);
+				return true;
+			}
+
+			// Reads "[...]" holding a filter or a list of names, indices, slices, and wildcards.
+			bool read_brackets(const std::string& t_path, size_t& t_position, Step& t_step)
+			{
+				t_position++;
+				skip_spaces(t_path, t_position);
+				if (consume(t_path, t_position, "?"))
+				{
+					Selector selector;
+					selector.m_kind = Selector_Kind::FILTER;
+					selector.m_filter = m_filters.size();
+					m_filters.emplace_back();
+					skip_spaces(t_path, t_position);
+					const bool parenthesized = consume(t_path, t_position, "(");
+					if (!read_filter(t_path, t_position, m_filters.back()))
+					{
+						return false;
+					}
+					skip_spaces(t_path, t_position);
+					if ((parenthesized && !consume(t_path, t_position, ")")))
+					{
+						return false;
+					}
+					skip_spaces(t_path, t_position);
+					t_step.m_selectors.push_back(std::move(selector));
+					return consume(t_path, t_position, "]");
+				}
+				while (true)
+				{
+					skip_spaces(t_path, t_position);
+					if (!read_bracket_selector(t_path, t_position, t_step))
+					{
+						return false;
+					}
+					skip_spaces(t_path, t_position);
+					if (consume(t_path, t_position, "]"))
+					{
+						return true;
+					}
+					if (!consume(t_path, t_position, ","))
+					{
+						return false;
+					}
+				}
+			}
+
+			static bool read_bracket_selector(const std::string& t_path, size_t& t_position, Step& t_step)
+			{
+				Selector selector;
+				if (t_position >= t_path.size())
+				{
+					return false;
+				}
+				if (t_path[t_position] == '\'' || t_path[t_position] == '"')
+				{
+					if (!read_quoted(t_path, t_position, selector.m_name))
+					{
+						return false;
+					}
+				}
+				else if (consume(t_path, t_position, "*"))
+				{
+					selector.m_kind = Selector_Kind::WILDCARD;
+				}
+				else
+				{
+					// index, or slice [start:end:step] with every part optional
+					selector.m_kind = Selector_Kind::INDEX;
+					selector.m_has_start = read_integer(t_path, t_position, selector.m_index);
+					skip_spaces(t_path, t_position);
+					if (consume(t_path, t_position, ":"))
+					{
+						selector.m_kind = Selector_Kind::SLICE;
+						skip_spaces(t_path, t_position);
+						selector.m_has_end = read_integer(t_path, t_position, selector.m_end);
+						skip_spaces(t_path, t_position);
+						if (consume(t_path, t_position, ":"))
+						{
+							skip_spaces(t_path, t_position);
+							if (!read_integer(t_path, t_position, selector.m_step))
+							{
+								selector.m_step = 1;
+							}
+						}
+					}
+					else if (!selector.m_has_start)
+					{
+						return false;
+					}
+				}
+				t_step.m_selectors.push_back(std::move(selector));
+				return true;
+			}
+
+			static bool read_filter(const std::string& t_path, size_t& t_position, Filter& t_filter)
+			{
+				t_filter.m_groups.emplace_back();
+				while (true)
+				{
+					Condition condition;
+					if (!read_condition(t_path, t_position, condition))
+					{
+						return false;
+					}
+					t_filter.m_groups.back().push_back(std::move(condition));
+					skip_spaces(t_path, t_position);
+					if (consume(t_path, t_position, "||"))
+					{
+						t_filter.m_groups.emplace_back();
+					}
+					else if (!consume(t_path, t_position, "&&"))
+					{
+						return true;
+					}
+				}
+			}
+
+			static bool read_condition(const std::string& t_path, size_t& t_position, Condition& t_condition)
+			{
+				skip_spaces(t_path, t_position);
+				t_condition.m_negate = consume(t_path, t_position, "!");
+				skip_spaces(t_path, t_position);
+				if (!consume(t_path, t_position, "@"))
+				{
+					return false;
+				}
+				while (t_position < t_path.size())
+				{
+					Filter_Token token;
+					if (consume(t_path, t_position, "."))
+					{
+						if (!read_name(t_path, t_position, token.m_name))
+						{
+							return false;
+						}
+					}
+					else if (consume(t_path, t_position, "["))
+					{
+						skip_spaces(t_path, t_position);
+						if (t_position < t_path.size() && (t_path[t_position] == '\'' || t_path[t_position] == '"'))
+						{
+							if (!read_quoted(t_path, t_position, token.m_name))
+							{
+								return false;
+							}
+						}
+						else if (read_integer(t_path, t_position, token.m_index))
+						{
+							token.m_is_index = true;
+						}
+						else
+						{
+							return false;
+						}
+						skip_spaces(t_path, t_position);
+						if (!consume(t_path, t_position, "]"))
+						{
+							return false;
+						}
+					}
+					else
+					{
+						break;
+					}
+					t_condition.m_path.push_back(std::move(token));
+				}
+				skip_spaces(t_path, t_position);
+				// two character operators are tried first
+				static const std::pair<const char*, Compare> operators[] = { { "==", Compare::EQUAL }, { "!=", Compare::NOT_EQUAL }, { "<=", Compare::LESS_EQUAL },
+					{ ">=", Compare::GREATER_EQUAL }, { "<", Compare::LESS }, { ">", Compare::GREATER } };
+				for (const std::pair<const char*, Compare>& entry : operators)
+				{
+					if (consume(t_path, t_position, entry.first))
+					{
+						t_condition.m_compare = entry.second;
+						skip_spaces(t_path, t_position);
+						return read_literal(t_path, t_position, t_condition);
+					}
+				}
+				return true;
+			}
+
+			static bool read_literal(const std::string& t_path, size_t& t_position, Condition& t_condition)
+			{
+				if (t_position >= t_path.size())
+				{
+					return false;
+				}
+				if (t_path[t_position] == '\'' || t_path[t_position] == '"')
+				{
+					if (!read_quoted(t_path, t_position, t_condition.m_text))
+					{
+						return false;
+					}
+					std::string quoted_value;
+					write_escaped_string(quoted_value, t_condition.m_text);
+					t_condition.m_literal.m_value_individual = std::move(quoted_value);
+					return true;
+				}
+				if (consume(t_path, t_position, "true"))
+				{
+					t_condition.m_literal.m_value_individual = true;
+					return true;
+				}
+				if (consume(t_path, t_position, "false"))
+				{
+					t_condition.m_literal.m_value_individual = false;
+					return true;
+				}
+				if (consume(t_path, t_position, "null"))
+				{
+					t_condition.m_literal.m_value_individual = nullptr;
+					return true;
+				}
+				const char* begin = t_path.data() + t_position;
+				const char* end = t_path.data() + t_path.size();
+				const char* number_end = begin;
+				double number = 0;
+				if (!validate_number(number_end, end) || std::from_chars(begin, number_end, number).ec != std::errc())
+				{
+					return false;
+				}
+				t_condition.m_literal.m_value_individual = number;
+				t_position += static_cast<size_t>(number_end - begin);
+				return true;
+			}
+		};
+
+		/*
+		* Runs a compiled JSONPath query over the document.
+		* @returns Pointers to the matching values in document order for each step, or nothing if the path is invalid.
+		* The values can be passed to the return, update, and delete methods. The root object itself is not a
+		* JSON_Value, so "$" alone matches only a root array. Pointers are invalidated by any change to the document.
+		*/
+		std::vector<Node::JSON_Value*> query(const Path& t_path)
+		{
+			std::vector<Node::JSON_Value*> results;
+			if (!t_path.m_valid)
+			{
+				return results;
+			}
+			std::vector<Path_Item> current;
+			std::vector<Path_Item> next;
+			Path_Item root;
+			root.m_elements = root_array(main_list);
+			if (root.m_elements != nullptr)
+			{
+				root.m_value = &std::get<std::vector<Node::JSON_KVP>>(main_list.m_kvp)[0].m_value;
+			}
+			else
+			{
+				root.m_object = &main_list;
+			}
+			current.push_back(root);
+			for (const Path::Step& step : t_path.m_steps)
+			{
+				next.clear();
+				for (const Path_Item& item : current)
+				{
+					if (step.m_recursive)
+					{
+						select_descendants(t_path, step, item, next);
+					}
+					else
+					{
+						select(t_path, step, item, next);
+					}
+				}
+				current.swap(next);
+			}
+			results.reserve(current.size());
+			for (const Path_Item& item : current)
+			{
+				if (item.m_value != nullptr)
+				{
+					results.push_back(item.m_value);
+				}
+			}
+			return results;
+		}
+
+		// Compiles t_path and runs it. Compile a Path once to run the same query many times.
+		std::vector<Node::JSON_Value*> query(const std::string& t_path)
+		{
+			return query(Path(t_path));
+		}
+
+	private:
+		// Value reached by a query, with the object or array it holds.
+		struct Path_Item
+		{
+			Node::JSON_Value* m_value = nullptr;	// nullptr for the root object
+			Node* m_object = nullptr;
+			std::vector<Node::JSON_Value>* m_elements = nullptr;
+		};
+
+		static Path_Item make_path_item(Node::JSON_Value& t_value) noexcept
+		{
+			Path_Item temp_item;
+			temp_item.m_value = &t_value;
+			if (std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				temp_item.m_object = temp_node->get();
+			}
+			else
+			{
+				temp_item.m_elements = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual);
+			}
+			return temp_item;
+		}
+
+		// Applies every selector of t_step to t_item and to everything below it.
+		static void select_descendants(const Path& t_path, const Path::Step& t_step, const Path_Item& t_item, std::vector<Path_Item>& t_output)
+		{
+			select(t_path, t_step, t_item, t_output);
+			if (t_item.m_object != nullptr)
+			{
+				if (std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_item.m_object->m_kvp))
+				{
+					for (Node::JSON_KVP& kvp : *temp_kvp_array)
+					{
+						if (!kvp.m_removed)
+						{
+							select_descendants(t_path, t_step, make_path_item(kvp.m_value), t_output);
+						}
+					}
+				}
+			}
+			else if (t_item.m_elements != nullptr)
+			{
+				for (Node::JSON_Value& element : *t_item.m_elements)
+				{
+					if (!element.m_removed)
+					{
+						select_descendants(t_path, t_step, make_path_item(element), t_output);
+					}
+				}
+			}
+		}
+
+		static void select(const Path& t_path, const Path::Step& t_step, const Path_Item& t_item, std::vector<Path_Item>& t_output)
+		{
+			std::vector<Node::JSON_KVP>* temp_kvp_array = t_item.m_object == nullptr ? nullptr : std::get_if<std::vector<Node::JSON_KVP>>(&t_item.m_object->m_kvp);
+			std::vector<Node::JSON_Value>* temp_array = t_item.m_elements;
+			for (const Path::Selector& selector : t_step.m_selectors)
+			{
+				switch (selector.m_kind)
+				{
+				case Path::Selector_Kind::NAME:
+					if (Node::JSON_Value* temp_value = find_path_member(temp_kvp_array, selector.m_name))
+					{
+						t_output.push_back(make_path_item(*temp_value));
+					}
+					break;
+				case Path::Selector_Kind::WILDCARD:
+				case Path::Selector_Kind::FILTER:
+					if (temp_kvp_array != nullptr)
+					{
+						for (Node::JSON_KVP& kvp : *temp_kvp_array)
+						{
+							if (!kvp.m_removed)
+							{
+								select_child(t_path, selector, kvp.m_value, t_output);
+							}
+						}
+					}
+					else if (temp_array != nullptr)
+					{
+						for (Node::JSON_Value& element : *temp_array)
+						{
+							if (!element.m_removed)
+							{
+								select_child(t_path, selector, element, t_output);
+							}
+						}
+					}
+					break;
+				case Path::Selector_Kind::INDEX:
+					if (Node::JSON_Value* temp_value = find_path_element(temp_array, selector.m_index))
+					{
+						t_output.push_back(make_path_item(*temp_value));
+					}
+					break;
+				case Path::Selector_Kind::SLICE:
+					if (temp_array != nullptr)
+					{
+						select_slice(selector, *temp_array, t_output);
+					}
+					break;
+				}
+			}
+		}
+
+		static void select_child(const Path& t_path, const Path::Selector& t_selector, Node::JSON_Value& t_child, std::vector<Path_Item>& t_output)
 		{
-			if (t_input.m_error_state == true)
+			Path_Item temp_item = make_path_item(t_child);
+			if (t_selector.m_kind == Path::Selector_Kind::WILDCARD || filter_matches(t_path.m_filters[t_selector.m_filter], temp_item))
 			{
-				delete& t_input;
-				return -1;
+				t_output.push_back(temp_item);
 			}
-			int output = -1;
-			const Node::JSON_Value* temp_value = std::get_if<Node::JSON_Value>(&t_input.m_value);
-			if (temp_value == nullptr)
+		}
+
+		// Selects elements the same way as RFC 9535 slices. Removed elements keep their positions but are skipped.
+		static void select_slice(const Path::Selector& t_selector, std::vector<Node::JSON_Value>& t_array, std::vector<Path_Item>& t_output)
+		{
+			const long long length = static_cast<long long>(t_array.size());
+			const long long step = t_selector.m_step;
+			if (step == 0)
 			{
-				return -1;
+				return;
 			}
-			else
+			auto normalize = [length](const long long t_index) { return t_index >= 0 ? t_index : length + t_index; };
+			if (step > 0)
 			{
-				if (std::holds_alternative<int>(temp_value->m_value_individual))
+				long long lower = t_selector.m_has_start ? std::min(std::max(normalize(t_selector.m_index), 0LL), length) : 0;
+				long long upper = t_selector.m_has_end ? std::min(std::max(normalize(t_selector.m_end), 0LL), length) : length;
+				for (long long i = lower; i < upper; i += step)
 				{
-					output = std::get<int>(temp_value->m_value_individual);
+					if (!t_array[static_cast<size_t>(i)].m_removed)
+					{
+						t_output.push_back(make_path_item(t_array[static_cast<size_t>(i)]));
+					}
+					if (upper - i <= step) // the next index is past the end, stop before i + step can overflow
+					{
+						break;
+					}
 				}
-				else
+				return;
+			}
+			long long upper = t_selector.m_has_start ? std::min(std::max(normalize(t_selector.m_index), -1LL), length - 1) : length - 1;
+			long long lower = t_selector.m_has_end ? std::min(std::max(normalize(t_selector.m_end), -1LL), length - 1) : -1;
+			for (long long i = upper; i > lower; i += step)
+			{
+				if (!t_array[static_cast<size_t>(i)].m_removed)
 				{
-					return -1;
+					t_output.push_back(make_path_item(t_array[static_cast<size_t>(i)]));
+				}
+				if (lower - i >= step)
+				{
+					break;
 				}
 			}
-			return output;
 		}
-		/*
-		* Returns a double contained in an array or -1 on error.
-		* @param t_input Array to be evaluated (usually obtained with an())
-		* @returns double
-		*/
-		static double r_double(const Node::JSON_Value& t_input)
+
+		// Returns the value of the first member named t_name, matched the same way as dn(), or nullptr.
+		static Node::JSON_Value* find_path_member(std::vector<Node::JSON_KVP>* t_members, const std::string& t_name) noexcept
 		{
-			if (t_input.m_error_state == true)
+			if (t_members == nullptr)
 			{
-				delete& t_input;
-				return -1;
+				return nullptr;
 			}
-			double output = -1;
-			if (std::holds_alternative<double>(t_input.m_value_individual))
+			for (Node::JSON_KVP& kvp : *t_members)
 			{
-				output = std::get<double>(t_input.m_value_individual);
+				if (!kvp.m_removed && trim_spaces(kvp.m_key) == t_name)
+				{
+					return &kvp.m_value;
+				}
 			}
-			return output;
+			return nullptr;
 		}
-		/*
-		* Returns a double contained in an object or -1 on error.
-		* @param t_input Obejct to be evaluated (usually obtained with dn())
-		* @returns double
-		*/
-		static double r_double(const Node::JSON_KVP& t_input)
+
+		static Node::JSON_Value* find_path_element(std::vector<Node::JSON_Value>* t_array, const long long t_index) noexcept
 		{
-			if (t_input.m_error_state == true)
+			if (t_array == nullptr)
 			{
-				delete& t_input;
-				return -1;
+				return nullptr;
 			}
-			double output = -1;
-			const Node::JSON_Value* temp_value = std::get_if<Node::JSON_Value>(&t_input.m_value);
-			if (temp_value == nullptr)
+			long long index = t_index >= 0 ? t_index : static_cast<long long>(t_array->size()) + t_index;
+			if (index < 0 || index >= static_cast<long long>(t_array->size()) || (*t_array)[static_cast<size_t>(index)].m_removed)
 			{
-				return -1;
+				return nullptr;
 			}
-			else
+			return &(*t_array)[static_cast<size_t>(index)];
+		}
+
+		static bool filter_matches(const Path::Filter& t_filter, const Path_Item& t_item)
+		{
+			for (const std::vector<Path::Condition>& group : t_filter.m_groups)
 			{
-				if (std::holds_alternative<double>(temp_value->m_value_individual))
+				bool group_holds = true;
+				for (const Path::Condition& condition : group)
 				{
-					output = std::get<double>(temp_value->m_value_individual);
+					if (!condition_holds(condition, t_item))
+					{
+						group_holds = false;
+						break;
+					}
 				}
-				else
+				if (group_holds)
 				{
-					return -1;
+					return true;
 				}
 			}
-			return output;
+			return false;
 		}
-		/*
-		* Returns a bool contained in an array or false on error.
-		* @param t_input Array to be evaluated (usually obtained with an())
-		* @returns bool
-		*/
-		static bool r_bool(const Node::JSON_Value& t_input)
+
+		static bool condition_holds(const Path::Condition& t_condition, const Path_Item& t_item)
 		{
-			if (t_input.m_error_state == true)
-			{
-				delete& t_input;
-				return false;
-			}
-			bool output = false;
-			if (std::holds_alternative<bool>(t_input.m_value_individual))
+			// follow the relative path from the current value
+			Path_Item target = t_item;
+			bool found = true;
+			for (const Path::Filter_Token& token : t_condition.m_path)
 			{
-				output = std::get<bool>(t_input.m_value_individual);
+				std::vector<Node::JSON_KVP>* temp_kvp_array = target.m_object == nullptr ? nullptr : std::get_if<std::vector<Node::JSON_KVP>>(&target.m_object->m_kvp);
+				Node::JSON_Value* temp_value = token.m_is_index ? find_path_element(target.m_elements, token.m_index) : find_path_member(temp_kvp_array, token.m_name);
+				if (temp_value == nullptr)
+				{
+					found = false;
+					break;
+				}
+				target = make_path_item(*temp_value);
 			}
-			return output;
-		}
-		/*
-		* Returns a bool contained in an object or false on error.
-		* @param t_input Object to be evaluated (usually obtained with dn())
-		* @returns bool
-		*/
-		static bool r_bool(const Node::JSON_KVP& t_input)
-		{
-			if (t_input.m_error_state == true)
+			bool holds = false;
+			if (t_condition.m_compare == Path::Compare::EXISTS)
 			{
-				delete& t_input;
-				return false;
+				holds = found;
 			}
-			bool output = false;
-			const Node::JSON_Value* temp_value = std::get_if<Node::JSON_Value>(&t_input.m_value);
-			if (temp_value == nullptr)
+			else if (t_condition.m_compare == Path::Compare::EQUAL || t_condition.m_compare == Path::Compare::NOT_EQUAL)
 			{
-				return false;
+				holds = found && target.m_value != nullptr && scalars_equal(*target.m_value, t_condition.m_literal);
+				holds = t_condition.m_compare == Path::Compare::EQUAL ? holds : !holds;
 			}
-			else
+			else if (found && target.m_value != nullptr)
 			{
-				if (std::holds_alternative<bool>(temp_value->m_value_individual))
-				{
-					output = std::get<bool>(temp_value->m_value_individual);
-				}
-				else
+				int order = 0;
+				if (compare_for_filter(*target.m_value, t_condition, order))
 				{
-					return false;
+					switch (t_condition.m_compare)
+					{
+					case Path::Compare::LESS: holds = order < 0; break;
+					case Path::Compare::LESS_EQUAL: holds = order <= 0; break;
+					case Path::Compare::GREATER: holds = order > 0; break;
+					default: holds = order >= 0; break;
+					}
 				}
 			}
-			return output;
+			return t_condition.m_negate ? !holds : holds;
 		}
-		/*
-		* Returns a string contained in an array or an empty string on error.
-		* @param t_input Array to be evaluated (usually obtained with an())
-		* @returns std::string
-		*/
-		static std::string r_string(const Node::JSON_Value& t_input)
+
+		// Orders a number against a number or a string against a string. Returns false for any other pair.
+		static bool compare_for_filter(const Node::JSON_Value& t_value, const Path::Condition& t_condition, int& t_order)
 		{
-			if (t_input.m_error_state == true)
-			{
-				delete& t_input;
-				return "";
-			}
-			std::string output = "";
-			if (std::holds_alternative<std::string>(t_input.m_value_individual))
+			if (is_number(t_value) && is_number(t_condition.m_literal))
 			{
-				output = std::get<std::string>(t_input.m_value_individual);
+				double left = number_of(t_value);
+				double right = number_of(t_condition.m_literal);
+				t_order = left < right ? -1 : (right < left ? 1 : 0);
+				return true;
 			}
-			return output;
-		}
-		/*
-		* Returns a string contained in an object or an empty string on error.
-		* @param t_input Object to be evaluated (usually obtained with dn())
-		* @returns std::string
-		*/
-		static std::string r_string(const Node::JSON_KVP& t_input)
-		{
-			if (t_input.m_error_state == true)
+			const std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual);
+			if (temp_string == nullptr || !std::holds_alternative<std::string>(t_condition.m_literal.m_value_individual) || temp_string->size() < 2)
 			{
-				delete& t_input;
-				return "";
+				return false;
 			}
-			std::string output = "";
-			const Node::JSON_Value* temp_value = std::get_if<Node::JSON_Value>(&t_input.m_value);
-			if (temp_value != nullptr)			
+			// strings are stored quoted, and only strings with escapes need to be decoded
+			std::string_view text(temp_string->data() + 1, temp_string->size() - 2);
+			std::string decoded;
+			if (text.find('\\') != std::string_view::npos)
 			{
-				if (std::holds_alternative<std::string>(temp_value->m_value_individual))
+				Scanner scanner(temp_string->data(), temp_string->data() + temp_string->size());
+				if (!scanner.read_string(decoded))
 				{
-					output = std::get<std::string>(temp_value->m_value_individual);
+					return false;
 				}
+				text = decoded;
 			}
-			return output;
+			int result = text.compare(t_condition.m_text);
+			t_order = result < 0 ? -1 : (result > 0 ? 1 : 0);
+			return true;
 		}
 
-		// ****NODE ACCESS****
 
+		//************************************************ COLUMNS **********************************************\\
+
+	public:
 		/*
-		* Method that returns a reference to the JSON_Value object located at a specific index in an array.
-		* A version of this exists in three classes: JSON, JSON_KVP, and JSON_Value. All methods have the
-		* same name to facilitate ease of use by the end user. Calls to an() and dn() can be chained in a similar
-		* manner to using array notation and dot notation when accessing JSON objects in Javascript. This is used
-		* primarily to provide a specific array index to the return, update, or delete methods.
-		* @returns JSON_Value&
+		* One field of every element of an array, stored contiguously. Only the buffer for m_type is filled and it
+		* always holds one entry per row, so rows without a value hold 0, false, or an empty string.
+		* m_valid has bit (row % 64) of word (row / 64) set when the row holds a value of the column's type, and
+		* m_null has it set when the row holds null. A row with neither bit set is missing the field, is not an
+		* object, or holds a value of another type.
 		*/
-		Node::JSON_Value& an(int t_index)
+		struct Column
 		{
-			std::vector<Node::JSON_KVP>* main_list_kvp = std::get_if<std::vector<Node::JSON_KVP>>(&main_list.m_kvp);
-			if (main_list_kvp == nullptr)
-			{
-				Node::JSON_Value* error_value = heap_allocate_error_value();
-				return *error_value;
-			}
-			
-			std::vector<Node::JSON_Value> *temp_kvp_array = std::get_if<std::vector<Node::JSON_Value>>(&(*main_list_kvp)[0].m_value);
+			enum class Type { INTEGER, DOUBLE, BOOL, STRING };
 
+			std::string m_field;
+			Type m_type = Type::DOUBLE;
+			std::vector<int64_t> m_ints;
+			std::vector<double> m_doubles;		// integers are converted
+			std::vector<uint8_t> m_bools;
+			std::vector<std::string> m_strings;	// unquoted
+			std::vector<uint64_t> m_valid;
+			std::vector<uint64_t> m_null;
 
-			if (t_index > temp_kvp_array->size())
+			bool valid(const size_t t_row) const noexcept
 			{
-				Node::JSON_Value* error_value = heap_allocate_error_value();
-				return *error_value;
+				return (m_valid[t_row / 64] >> (t_row % 64)) & 1;
 			}
-			else
-			{
-				Node::JSON_Value& temp_value = (*temp_kvp_array)[t_index];
-				return temp_value;
-			}		
 
-		}
+			bool null(const size_t t_row) const noexcept
+			{
+				return (m_null[t_row / 64] >> (t_row % 64)) & 1;
+			}
+		};
 
 		/*
-		* Method that returns a reference to a JSON_KVP object located inside of a JSON object. A version of this
-		* method exists across three classes: JSON, JSON_KVP, and JSON_Value. All methods have the
-		* same name to facilitate ease of use by the end user. Calls to an() and dn() can be chained in a similar
-		* manner to using array notation and dot notation when accessing JSON objects in Javascript. This is used
-		* primarily to provide a specific object to the return, update, or delete methods.
-		* @returns JSON_KVP&
+		* Extracts fields from every object of one array in JSON text into typed columns in a single pass, without
+		* building a JSON structure. The array is found with the same dot and bracket paths as Path_Extractor, for
+		* example "data.rows" or "[2].points", and an empty path selects a root array. Values outside the array and
+		* fields that are not columns are skipped by bracket matching, and scanning stops when the array ends.
+		* The first occurrence of a repeated key is kept, the same as dn(). The extractor keeps the capacity of its
+		* columns and can be reused for any number of inputs.
 		*/
-		Node::JSON_KVP& dn(std::string t_key)
+		class Column_Extractor
 		{
-			return main_list.find_by_key(t_key);
-		}
-
-		//************************************************ UPDATE ***********************************************\\
+		private:
+			std::vector<Dot_Path_Step> m_steps;
+			bool m_valid = false;	// the array path could be read
+			std::vector<Column> m_columns;
+			size_t m_rows = 0;
+			bool m_found = false;
+			std::string m_key_buffer;
 
-		// Updates an objects key
-		void static update_key(const std::string t_new_key, Node::JSON_KVP& t_object) noexcept
-		{
-			if (t_object.m_error_state == false)
+		public:
+			Column_Extractor(const std::string& t_array_path, const std::vector<std::pair<std::string, Column::Type>>& t_fields)
 			{
-				t_object.m_key = t_new_key;
+				m_valid = read_dot_path(t_array_path, m_steps);
+				for (const std::pair<std::string, Column::Type>& field : t_fields)
+				{
+					Column column;
+					column.m_field = field.first;
+					column.m_type = field.second;
+					m_columns.push_back(std::move(column));
+				}
 			}
-			else
+
+			/*
+			* Scans JSON text and fills the columns, replacing the results of any previous call.
+			* @param t_json_input JSON formatted text input.
+			* @returns false on a syntax error before the end of the array. A missing array is not an error and gives
+			* no rows, and an invalid path is never found.
+			*/
+			bool extract(const std::string& t_json_input)
 			{
-				delete &t_object;
+				m_rows = 0;
+				m_found = false;
+				for (Column& column : m_columns)
+				{
+					column.m_ints.clear();
+					column.m_doubles.clear();
+					column.m_bools.clear();
+					column.m_strings.clear();
+					column.m_valid.clear();
+					column.m_null.clear();
+				}
+				if (!m_valid)
+				{
+					return true;
+				}
+				Scanner scanner(t_json_input.data(), t_json_input.data() + t_json_input.size());
+				return find_array(scanner, 0);
 			}
-		}
 
-		// Overloaded method to update an objects value to a new value of any type
-		void static update_value(const int t_new_value, Node::JSON_KVP& t_object) noexcept
-		{
-			if (t_object.m_error_state == false)
+			// Returns the column for the field at t_index in the list given to the constructor.
+			const Column& operator[](const size_t t_index) const
 			{
-				Node::JSON_Value* value_ptr = std::get_if<Node::JSON_Value>(&t_object.m_value);
-				value_ptr->m_value_individual = t_new_value;
+				return m_columns[t_index];
 			}
-			else
+
+			// Returns the number of columns.
+			size_t size() const noexcept
 			{
-				delete& t_object;
+				return m_columns.size();
 			}
-		}
-		void static update_value(const double t_new_value, Node::JSON_KVP& t_object) noexcept
-		{
-			if (t_object.m_error_state == false)
+
+			// Returns the number of elements in the array, which is the length of every column.
+			size_t rows() const noexcept
 			{
-				Node::JSON_Value* value_ptr = std::get_if<Node::JSON_Value>(&t_object.m_value);
-				value_ptr->m_value_individual = t_new_value;
+				return m_rows;
 			}
-			else
+
+			// Returns true if the last input held an array at the path.
+			bool found() const noexcept
 			{
-				delete& t_object;
+				return m_found;
 			}
-		}
-		void static update_value(const bool t_new_value, Node::JSON_KVP& t_object) noexcept
-		{
-			if (t_object.m_error_state == false)
+
+			// Returns false if the array path could not be read.
+			bool valid() const noexcept
 			{
-				Node::JSON_Value* value_ptr = std::get_if<Node::JSON_Value>(&t_object.m_value);
-				value_ptr->m_value_individual = t_new_value;
+				return m_valid;
 			}
-			else
+
+		private:
+			/*
+			* Follows the steps from t_step to the array. Members and elements not on the path are skipped.
+			* @returns false on a syntax error.
+			*/
+			bool find_array(Scanner& t_scanner, const size_t t_step)
 			{
-				delete& t_object;
+				t_scanner.skip_whitespace();
+				char first = t_scanner.peek();
+				if (t_step == m_steps.size())
+				{
+					return first == '[' ? extract_rows(t_scanner) : t_scanner.skip_value();
+				}
+				const Dot_Path_Step& step = m_steps[t_step];
+				if (first != (step.m_index < 0 ? '{' : '['))
+				{
+					return t_scanner.skip_value();
+				}
+				t_scanner.m_current++;
+				t_scanner.skip_whitespace();
+				if (t_scanner.consume(first == '{' ? '}' : ']'))
+				{
+					return true;
+				}
+				int index = 0;
+				while (true)
+				{
+					bool on_path = false;
+					if (first == '{')
+					{
+						t_scanner.skip_whitespace();
+						if (!t_scanner.read_key(m_key_buffer))
+						{
+							return false;
+						}
+						t_scanner.skip_whitespace();
+						if (!t_scanner.consume(':'))
+						{
+							return t_scanner.fail();
+						}
+						on_path = m_key_buffer == step.m_key;
+					}
+					else
+					{
+						on_path = index++ == step.m_index;
+					}
+					if (on_path)
+					{
+						return find_array(t_scanner, t_step + 1);
+					}
+					if (!t_scanner.skip_value())
+					{
+						return false;
+					}
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume(first == '{' ? '}' : ']'))
+					{
+						return true;
+					}
+					if (!t_scanner.consume(','))
+					{
+						return t_scanner.fail();
+					}
+				}
 			}
-		}
-		void static update_value(const std::string t_new_value, Node::JSON_KVP& t_object) noexcept
-		{
-			if (t_object.m_error_state == false)
+
+			// Reads the elements of the array at the current position, adding one row to every column for each.
+			bool extract_rows(Scanner& t_scanner)
 			{
-				Node::JSON_Value* value_ptr = std::get_if<Node::JSON_Value>(&t_object.m_value);
-				value_ptr->m_value_individual = t_new_value;
+				m_found = true;
+				t_scanner.m_current++;
+				t_scanner.skip_whitespace();
+				if (t_scanner.consume(']'))
+				{
+					return true;
+				}
+				while (true)
+				{
+					add_row();
+					t_scanner.skip_whitespace();
+					if (t_scanner.peek() == '{')
+					{
+						if (!extract_fields(t_scanner))
+						{
+							return false;
+						}
+					}
+					else if (!t_scanner.skip_value())
+					{
+						return false;
+					}
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume(']'))
+					{
+						return true;
+					}
+					if (!t_scanner.consume(','))
+					{
+						return t_scanner.fail();
+					}
+				}
 			}
-			else
+
+			void add_row()
 			{
-				delete& t_object;
+				const size_t row = m_rows++;
+				for (Column& column : m_columns)
+				{
+					switch (column.m_type)
+					{
+					case Column::Type::INTEGER: column.m_ints.push_back(0); break;
+					case Column::Type::DOUBLE: column.m_doubles.push_back(0); break;
+					case Column::Type::BOOL: column.m_bools.push_back(0); break;
+					case Column::Type::STRING: column.m_strings.emplace_back(); break;
+					}
+					if (row % 64 == 0)
+					{
+						column.m_valid.push_back(0);
+						column.m_null.push_back(0);
+					}
+				}
 			}
-		}
-		void static update_value(const int t_new_value, Node::JSON_Value& t_value) noexcept
-		{
-			if (t_value.m_error_state == false)
+
+			// Reads the object of the last row, storing the fields that are columns.
+			bool extract_fields(Scanner& t_scanner)
 			{
-				t_value.m_value_individual = t_new_value;
+				t_scanner.m_current++;
+				t_scanner.skip_whitespace();
+				if (t_scanner.consume('}'))
+				{
+					return true;
+				}
+				const size_t row = m_rows - 1;
+				const uint64_t bit = uint64_t(1) << (row % 64);
+				while (true)
+				{
+					t_scanner.skip_whitespace();
+					if (!t_scanner.read_key(m_key_buffer))
+					{
+						return false;
+					}
+					t_scanner.skip_whitespace();
+					if (!t_scanner.consume(':'))
+					{
+						return t_scanner.fail();
+					}
+					t_scanner.skip_whitespace();
+					Column* column = nullptr;
+					for (Column& candidate : m_columns)
+					{
+						if (candidate.m_field == m_key_buffer && ((candidate.m_valid.back() | candidate.m_null.back()) & bit) == 0)
+						{
+							column = &candidate;
+							break;
+						}
+					}
+					if (column == nullptr ? !t_scanner.skip_value() : !read_cell(t_scanner, *column, row, bit))
+					{
+						return false;
+					}
+					t_scanner.skip_whitespace();
+					if (t_scanner.consume('}'))
+					{
+						return true;
+					}
+					if (!t_scanner.consume(','))
+					{
+						return t_scanner.fail();
+					}
+				}
 			}
-			else
+
+			/*
+			* Reads the value at the current position into t_row of the column. Null sets the null bit, a value of the
+			* column's type sets the valid bit, and anything else is skipped. Integers are accepted by DOUBLE columns.
+			*/
+			static bool read_cell(Scanner& t_scanner, Column& t_column, const size_t t_row, const uint64_t t_bit)
 			{
-				delete& t_value;
+				char first = t_scanner.peek();
+				if (t_scanner.consume_literal("null"))
+				{
+					t_column.m_null.back() |= t_bit;
+					return true;
+				}
+				bool matches = false;
+				switch (t_column.m_type)
+				{
+				case Column::Type::STRING:
+					if (first == '"' || first == '\'')
+					{
+						if (!t_scanner.read_string(t_column.m_strings[t_row]))
+						{
+							return false;
+						}
+						matches = true;
+					}
+					break;
+				case Column::Type::BOOL:
+					if (t_scanner.consume_literal("true") || t_scanner.consume_literal("false"))
+					{
+						t_column.m_bools[t_row] = first == 't';
+						matches = true;
+					}
+					break;
+				default:
+					if (first == '-' || (first >= '0' && first <= '9'))
+					{
+						bool stored = false;
+						if (!read_number_cell(t_scanner, t_column, t_row, stored))
+						{
+							return false;
+						}
+						t_column.m_valid.back() |= stored ? t_bit : 0;
+						return true;
+					}
+					break;
+				}
+				if (!matches)
+				{
+					return t_scanner.skip_value();
+				}
+				t_column.m_valid.back() |= t_bit;
+				return true;
 			}
-		}
-		void static update_value(const double t_new_value, Node::JSON_Value& t_value) noexcept
-		{
-			if (t_value.m_error_state == false)
+
+			// Numbers that do not fit the column, such as 1.5 in an INTEGER column, are read but not stored.
+			static bool read_number_cell(Scanner& t_scanner, Column& t_column, const size_t t_row, bool& t_stored)
 			{
-				t_value.m_value_individual = t_new_value;
+				const char* number_begin = nullptr;
+				const char* number_end = nullptr;
+				if (!t_scanner.read_number(number_begin, number_end))
+				{
+					return false;
+				}
+				if (t_column.m_type == Column::Type::INTEGER && !Scanner::is_floating_point(number_begin, number_end))
+				{
+					std::from_chars_result result = std::from_chars(number_begin, number_end, t_column.m_ints[t_row]);
+					if (result.ec == std::errc() && result.ptr == number_end)
+					{
+						t_stored = true;
+						return true;
+					}
+				}
+				// malformed numbers are syntax errors, the same as in parse()
+				double temp_double = 0;
+				std::from_chars_result result = std::from_chars(number_begin, number_end, temp_double);
+				if (result.ec != std::errc() || result.ptr != number_end)
+				{
+					t_scanner.m_current = number_begin;
+					return t_scanner.fail();
+				}
+				if (t_column.m_type == Column::Type::DOUBLE)
+				{
+					t_column.m_doubles[t_row] = temp_double;
+					t_stored = true;
+				}
+				return true;
 			}
-			else
+		};
+
+
+		//*********************************************** PARALLEL **********************************************\\
+
+	public:
+		/*
+		* Serializes a document on several threads. Objects and arrays are split into ranges of members or elements
+		* that are written concurrently into separate buffers and joined in order, so the output is byte-identical to
+		* serialize(). Large containers are split into ranges and smaller ones are descended into until there are
+		* about four ranges per thread, so the work is balanced by count rather than by size.
+		* The serialize cache is neither read nor written. The document must not be changed while this runs.
+		* @param t_threads Number of threads to use, or 0 for std::thread::hardware_concurrency().
+		* @returns std::string
+		*/
+		static std::string serialize_parallel(const JSON& t_main_list, const unsigned t_threads = 0)
+		{
+			std::vector<Serialize_Piece> pieces;
+			if (!serialize_pieces(t_main_list, t_threads, pieces))
 			{
-				delete& t_value;
+				return serialize(t_main_list);
 			}
-		}
-		void static update_value(const bool t_new_value, Node::JSON_Value& t_value) noexcept
-		{
-			if (t_value.m_error_state == false)
+			size_t total_size = 0;
+			for (const Serialize_Piece& piece : pieces)
 			{
-				t_value.m_value_individual = t_new_value;
+				total_size += piece.m_text.size();
 			}
-			else
+			std::string output;
+			output.reserve(total_size);
+			for (const Serialize_Piece& piece : pieces)
 			{
-				delete& t_value;
+				output += piece.m_text;
 			}
+			return output;
 		}
-		void static update_value(const std::string t_new_value, Node::JSON_Value& t_value) noexcept
+
+		/*
+		* Same as serialize_parallel() but writes the pieces to t_output one after another instead of joining them,
+		* which saves a copy of the whole text when writing to a file.
+		* @returns false if writing to the stream failed.
+		*/
+		static bool serialize_parallel(const JSON& t_main_list, std::ostream& t_output, const unsigned t_threads = 0)
 		{
-			if (t_value.m_error_state == false)
+			std::vector<Serialize_Piece> pieces;
+			if (!serialize_pieces(t_main_list, t_threads, pieces))
 			{
-				t_value.m_value_individual = t_new_value;
+				std::string text = serialize(t_main_list);
+				t_output.write(text.data(), static_cast<std::streamsize>(text.size()));
+				return static_cast<bool>(t_output);
 			}
-			else
+			for (const Serialize_Piece& piece : pieces)
 			{
-				delete& t_value;
+				t_output.write(piece.m_text.data(), static_cast<std::streamsize>(piece.m_text.size()));
 			}
+			return static_cast<bool>(t_output);
 		}
 
-		//************************************************ DELETE ***********************************************\\
+	private:
+		static constexpr unsigned k_pieces_per_thread = 4;
 
-		// Traverses the entire JSON structure and deletes the first instance of the key that it finds.
-		void remove_first_found(const std::string t_key)
+		/*
+		* Part of the output of serialize_parallel(). A piece with a container writes the members or elements in
+		* [m_begin, m_end) of it, others hold fixed text such as brackets, keys, and small values.
+		*/
+		struct Serialize_Piece
 		{
-			std::pair<std::vector<Node::JSON_KVP>*, int> vector_reference_and_index = main_list.recursive_find_parent_vector_and_index(t_key);
-			if (vector_reference_and_index.first != nullptr)
+			const std::vector<Node::JSON_KVP>* m_members = nullptr;
+			const std::vector<Node::JSON_Value>* m_elements = nullptr;
+			size_t m_begin = 0;
+			size_t m_end = 0;
+			bool m_separate = false;	// an earlier member or element of the same container is written
+			std::string m_text;
+		};
+
+		/*
+		* Splits the document into pieces and writes them on t_threads threads.
+		* @returns false if fewer than two threads would be used, in which case nothing is written.
+		*/
+		static bool serialize_pieces(const JSON& t_main_list, const unsigned t_threads, std::vector<Serialize_Piece>& t_pieces)
+		{
+			unsigned threads = t_threads != 0 ? t_threads : std::thread::hardware_concurrency();
+			if (threads < 2)
 			{
-				std::vector<Node::JSON_KVP>* temp_vector_ptr = vector_reference_and_index.first;
-				int vector_index = vector_reference_and_index.second;
-				temp_vector_ptr->erase(temp_vector_ptr->begin() + vector_index);
+				return false;
 			}
-		}
+			plan_node(t_main_list.main_list, static_cast<size_t>(threads) * k_pieces_per_thread, t_pieces);
 
-		// Overloaded method that deletes an index from an array or nested array
-		void static remove_from_array(Node::JSON_Value& t_array, const int t_index)
-		{
-			if (t_array.m_error_state == false)
+			std::vector<size_t> work;
+			for (size_t i = 0; i < t_pieces.size(); i++)
 			{
-				std::shared_ptr<std::vector<Node::JSON_Value>>* temp_array_ptr = std::get_if<std::shared_ptr<std::vector<Node::JSON_Value>>>(&t_array.m_value_individual);
-				if (temp_array_ptr != nullptr)
+				if (t_pieces[i].m_members != nullptr || t_pieces[i].m_elements != nullptr)
 				{
-					(*temp_array_ptr)->erase((*temp_array_ptr)->begin() + t_index);
+					work.push_back(i);
 				}
 			}
-			else
-			{
-				delete& t_array;
-			}
-		}
-		void static remove_from_array(Node::JSON_KVP& t_object, const int t_index)
-
-		{
-			if (t_object.m_error_state == false)
+			std::atomic<size_t> next_work(0);
+			auto run = [&t_pieces, &work, &next_work]()
 			{
-				std::vector<Node::JSON_Value>* temp_value_ptr = std::get_if<std::vector<Node::JSON_Value>>(&t_object.m_value);
-				if (temp_value_ptr != nullptr)
+				for (size_t i = next_work++; i < work.size(); i = next_work++)
 				{
-					temp_value_ptr->erase(temp_value_ptr->begin() + t_index);
+					write_piece(t_pieces[work[i]]);
 				}
+			};
+			std::vector<std::thread> workers;
+			const size_t worker_count = std::min(static_cast<size_t>(threads), work.size());
+			for (size_t i = 1; i < worker_count; i++)
+			{
+				workers.emplace_back(run);
 			}
-			else
+			run();
+			for (std::thread& worker : workers)
 			{
-				delete& t_object;
+				worker.join();
 			}
+			return true;
 		}
 
-		// Deletes a key value pair from an object
-		void static remove_from_object(Node::JSON_KVP& t_object, const std::string t_key)
+		static Serialize_Piece& text_piece(std::vector<Serialize_Piece>& t_pieces)
 		{
-			if (t_object.m_error_state == false)
+			if (t_pieces.empty() || t_pieces.back().m_members != nullptr || t_pieces.back().m_elements != nullptr)
 			{
-				Node::JSON_Value* temp_value_ptr = std::get_if<Node::JSON_Value>(&t_object.m_value);
-				if (temp_value_ptr != nullptr)
-				{
-					std::shared_ptr<Node>* temp_node_ptr = std::get_if<std::shared_ptr<Node>>(&temp_value_ptr->m_value_individual);
-					if (temp_node_ptr != nullptr)
-					{
-						std::vector<Node::JSON_KVP>* temp_object_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&(*temp_node_ptr)->m_kvp);
-						if (temp_object_vector_ptr != nullptr)
-						{
-							for (int i = 0; i < temp_object_vector_ptr->size(); i++)
-							{
-								Node::JSON_KVP current_object = (*temp_object_vector_ptr)[i];
-								if (format_value(current_object.m_key) == t_key)
-								{
-									temp_object_vector_ptr->erase(temp_object_vector_ptr->begin() + i);
-									break;
-								}
-							}
-						}
-					}
-				}
+				t_pieces.emplace_back();
 			}
-			else
+			return t_pieces.back();
+		}
+
+		// Adds the pieces of an object, mirroring write_node().
+		static void plan_node(const Node& t_node_object, const size_t t_budget, std::vector<Serialize_Piece>& t_pieces)
+		{
+			const std::vector<Node::JSON_KVP>* temp_kvp_array = std::get_if<std::vector<Node::JSON_KVP>>(&t_node_object.m_kvp);
+			if (temp_kvp_array == nullptr)
 			{
-				delete& t_object;
+				text_piece(t_pieces).m_text += "NULL";
+				return;
 			}
+			text_piece(t_pieces).m_text += '{';
+			plan_children(temp_kvp_array, nullptr, temp_kvp_array->size(), t_budget, t_pieces);
+			text_piece(t_pieces).m_text += '}';
 		}
 
-		//*********************************************** SERIALIZE *********************************************\\
-
-		/**
-		* Serializes the contents of the curent JSON structure.
-		* Will be a "flat packed" JSON object with no newline formatting.
-		* @param t_node_object A nested JSON object within the JSON structure.
-		* @returns std::string
+		/*
+		* Adds the pieces for the members or the elements of a container. With at least as many children as the
+		* budget the children are split into t_budget ranges. Otherwise the budget is shared between the children,
+		* containers with a budget above one are planned the same way, and other children become one piece each.
 		*/
-		static std::string serialize(const Node& t_node_object)
+		static void plan_children(const std::vector<Node::JSON_KVP>* t_members, const std::vector<Node::JSON_Value>* t_elements, const size_t t_count, const size_t t_budget,
+			std::vector<Serialize_Piece>& t_pieces)
 		{
-			std::stringstream output;
-			output << "{";
-			const std::vector<Node::JSON_KVP>* main_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&t_node_object.m_kvp);
-			if (main_vector_ptr == nullptr)
+			auto removed = [t_members, t_elements](const size_t t_index) { return t_members != nullptr ? (*t_members)[t_index].m_removed : (*t_elements)[t_index].m_removed; };
+			bool separate = false;
+			if (t_budget <= 1 || t_count >= t_budget)
 			{
-				return "NULL";
+				const size_t ranges = std::max<size_t>(t_budget, 1);
+				for (size_t range = 0; range < ranges; range++)
+				{
+					Serialize_Piece piece;
+					piece.m_members = t_members;
+					piece.m_elements = t_elements;
+					piece.m_begin = t_count * range / ranges;
+					piece.m_end = t_count * (range + 1) / ranges;
+					piece.m_separate = separate;
+					for (size_t i = piece.m_begin; i < piece.m_end && !separate; i++)
+					{
+						separate = !removed(i);
+					}
+					t_pieces.push_back(std::move(piece));
+				}
+				return;
 			}
-			// read through KVP vector and insert keys and values into stream
-			// makes recursive calls to serialize when encountering another object
-			for (int i = 0; i < main_vector_ptr->size(); i++)
+			const size_t child_budget = t_budget / std::max<size_t>(t_count, 1);
+			for (size_t i = 0; i < t_count; i++)
 			{
-				output << (*main_vector_ptr)[i].m_key;
-				output << " : ";				
-
-				if (std::holds_alternative<std::vector<Node::JSON_Value>>((*main_vector_ptr)[i].m_value))
+				if (removed(i))
 				{
-					const std::vector<Node::JSON_Value>* temp_value_ptr = std::get_if<std::vector<Node::JSON_Value>>(&(*main_vector_ptr)[i].m_value);
-					output << convert_to_text(*temp_value_ptr);
+					continue;
 				}
-				else if (std::holds_alternative<Node::JSON_Value>((*main_vector_ptr)[i].m_value))
+				const Node::JSON_Value& value = t_members != nullptr ? (*t_members)[i].m_value : (*t_elements)[i];
+				const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&value.m_value_individual);
+				const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&value.m_value_individual);
+				if (child_budget <= 1 || (temp_node == nullptr && temp_array == nullptr))
 				{
-					const Node::JSON_Value* temp_value_ptr = std::get_if<Node::JSON_Value>(&(*main_vector_ptr)[i].m_value);
-					if (std::holds_alternative<std::shared_ptr<Node>>(temp_value_ptr->m_value_individual)) // is an object
+					Serialize_Piece piece;
+					piece.m_members = t_members;
+					piece.m_elements = t_elements;
+					piece.m_begin = i;
+					piece.m_end = i + 1;
+					piece.m_separate = separate;
+					if (temp_node == nullptr && temp_array == nullptr)
 					{
-						const std::shared_ptr<Node>* temp_value_individual_ptr = std::get_if<std::shared_ptr<Node>>(&temp_value_ptr->m_value_individual);
-						output << serialize(**temp_value_individual_ptr);
+						// scalars are cheap, write them now and merge them with the text around them
+						write_piece(piece);
+						text_piece(t_pieces).m_text += piece.m_text;
 					}
-					else // is a primitive value
+					else
 					{
-						std::string converted_value = "";
-						// determine type and convert to string
-						if (std::holds_alternative<int>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<int>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<double>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<double>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<bool>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<bool>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<std::string>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::get<std::string>(temp_value_ptr->m_value_individual);
-						}
-						output << converted_value;
+						t_pieces.push_back(std::move(piece));
 					}
 				}
-				else // uninitialized variant
-				{
-					return "NULL";
-				}
-
-				if (i < (main_vector_ptr->size() - 1))
-				{
-					output << ", ";
-				}
-				else // end of object
+				else
 				{
-					output << '}';
+					std::string& text = text_piece(t_pieces).m_text;
+					if (separate)
+					{
+						text += ", ";
+					}
+					if (t_members != nullptr)
+					{
+						text += (*t_members)[i].m_key;
+						text += " : ";
+					}
+					if (temp_node != nullptr)
+					{
+						plan_node(**temp_node, child_budget, t_pieces);
+					}
+					else
+					{
+						text_piece(t_pieces).m_text += '[';
+						plan_children(nullptr, temp_array, temp_array->size(), child_budget, t_pieces);
+						text_piece(t_pieces).m_text += ']';
+					}
 				}
+				separate = true;
 			}
-			return output.str();
 		}
 
-		// there must be a cleaner way to do this - function needs to be able to handle a Node object as well as a JSON_list
-		// object in order to make recursive calls
-		static std::string serialize(const JSON& t_main_list)
+		// Writes the members or elements of a piece the same way as write_node() and convert_to_text().
+		static void write_piece(Serialize_Piece& t_piece)
 		{
-			std::stringstream output;
-			output << "{";
-			const std::vector<Node::JSON_KVP>* main_vector_ptr = std::get_if<std::vector<Node::JSON_KVP>>(&t_main_list.main_list.m_kvp);
-			if (main_vector_ptr == nullptr)
-			{
-				return "NULL";
-			}
-			// read through KVP vector and insert keys and values into stream
-			// makes recursive calls to serialize when encountering another object
-			for (int i = 0; i < main_vector_ptr->size(); i++)
+			bool separate = t_piece.m_separate;
+			for (size_t i = t_piece.m_begin; i < t_piece.m_end; i++)
 			{
-				output << (*main_vector_ptr)[i].m_key;
-				output << " : ";
-
-				if (std::holds_alternative<std::vector<Node::JSON_Value>>((*main_vector_ptr)[i].m_value))
-				{
-					const std::vector<Node::JSON_Value>* temp_value_ptr = std::get_if<std::vector<Node::JSON_Value>>(&(*main_vector_ptr)[i].m_value);
-					output << convert_to_text(*temp_value_ptr);
-				}
-				else if (std::holds_alternative<Node::JSON_Value>((*main_vector_ptr)[i].m_value))
+				const Node::JSON_Value* temp_value = nullptr;
+				if (t_piece.m_members != nullptr)
 				{
-					const Node::JSON_Value* temp_value_ptr = std::get_if<Node::JSON_Value>(&(*main_vector_ptr)[i].m_value);
-					if (std::holds_alternative<std::shared_ptr<Node>>(temp_value_ptr->m_value_individual)) // is an object
+					const Node::JSON_KVP& kvp = (*t_piece.m_members)[i];
+					if (kvp.m_removed)
 					{
-						const std::shared_ptr<Node>* temp_value_individual_ptr = std::get_if<std::shared_ptr<Node>>(&temp_value_ptr->m_value_individual);
-						output << serialize(**temp_value_individual_ptr);
+						continue;
 					}
-					else // is a primitive value
+					if (separate)
 					{
-						std::string converted_value = "";
-						//determine type and convert to string
-						if (std::holds_alternative<int>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<int>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<double>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<double>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<bool>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::to_string(std::get<bool>(temp_value_ptr->m_value_individual));
-						}
-						else if (std::holds_alternative<std::string>(temp_value_ptr->m_value_individual))
-						{
-							converted_value = std::get<std::string>(temp_value_ptr->m_value_individual);
-						}
-						output << converted_value;
+						t_piece.m_text += ", ";
 					}
+					t_piece.m_text += kvp.m_key;
+					t_piece.m_text += " : ";
+					temp_value = &kvp.m_value;
 				}
-				else // uninitialized variant
-				{
-					return "NULL";
-				}
-				if (i < (main_vector_ptr->size() - 1))
-				{
-					output << ", ";
-				}
-				else // end of object
+				else
 				{
-					output << '}';
+					temp_value = &(*t_piece.m_elements)[i];
+					if (temp_value->m_removed)
+					{
+						continue;
+					}
+					if (separate)
+					{
+						t_piece.m_text += ", ";
+					}
 				}
+				separate = true;
+				write_value_text(*temp_value, t_piece.m_text);
+			}
+		}
+
+		static void write_value_text(const Node::JSON_Value& t_value, std::string& t_output)
+		{
+			if (const std::shared_ptr<Node>* temp_node = std::get_if<std::shared_ptr<Node>>(&t_value.m_value_individual))
+			{
+				write_node(**temp_node, t_output, false);
+			}
+			else if (const std::vector<Node::JSON_Value>* temp_array = std::get_if<std::vector<Node::JSON_Value>>(&t_value.m_value_individual))
+			{
+				t_output += convert_to_text(*temp_array);
+			}
+			else if (const int* temp_int = std::get_if<int>(&t_value.m_value_individual))
+			{
+				t_output += std::to_string(*temp_int);
+			}
+			else if (const double* temp_double = std::get_if<double>(&t_value.m_value_individual))
+			{
+				t_output += std::to_string(*temp_double);
+			}
+			else if (const Node::JSON_Value::Number* temp_number = std::get_if<Node::JSON_Value::Number>(&t_value.m_value_individual))
+			{
+				t_output += temp_number->m_text;
+			}
+			else if (const bool* temp_bool = std::get_if<bool>(&t_value.m_value_individual))
+			{
+				t_output += std::to_string(*temp_bool);
+			}
+			else if (const std::string* temp_string = std::get_if<std::string>(&t_value.m_value_individual))
+			{
+				t_output += *temp_string;
+			}
+			else if (std::holds_alternative<std::nullptr_t>(t_value.m_value_individual))
+			{
+				t_output += "null";
 			}
-			return output.str();
 		}
 	};
+
+	namespace literals
+	{
+		// "name"_key makes a JSON::Key for dn() without allocating.
+		constexpr JSON::Key operator""_key(const char* t_text, const size_t t_size) noexcept
+		{
+			return JSON::Key(std::string_view(t_text, t_size));
+		}
+	}
 }
 
+// Allows a JSON to be used as the key of std::unordered_map and std::unordered_set.
+template<>
+struct std::hash<JSONator::JSON>
+{
+	size_t operator()(const JSONator::JSON& t_json) const
+	{
+		return t_json.hash();
+	}
+};
+
 #endif // !jsonator.h
 